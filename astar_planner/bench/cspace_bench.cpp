@@ -0,0 +1,133 @@
+/*!
+   \file cspace_bench.cpp
+   \brief Measures the break-even number of collision tests per map of the heading layers.
+
+   For every occupancy image the dilation of the heading layers is timed against random configurations tested
+   with the circles and footprints of the collision detection and with a bit lookup in the layers.
+   The layers pay off once a map sees more tests than the dilation costs divided by the time saved per test.
+   The conservative share counts the configurations the layers block although their footprint is free.
+
+   usage: cspace_bench [-n queries] image...
+*/
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "opencv2/opencv.hpp"
+
+#include "binarygrid.h"
+#include "clock.h"
+#include "collisiondetection.h"
+#include "constants.h"
+#include "dynamicvoronoi.h"
+#include "headinglayers.h"
+#include "lookup.h"
+#include "parameters.h"
+
+using namespace HybridAStar;
+
+/// keeps the compiler from discarding the tests
+static volatile int sink;
+
+int main(int argc, char** argv) {
+  int queries = 1000000;
+  std::vector<std::string> images;
+
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "-n") && i + 1 < argc) {
+      queries = std::atoi(argv[++i]);
+    } else {
+      images.push_back(argv[i]);
+    }
+  }
+
+  if (images.empty()) {
+    std::cerr << "usage: " << argv[0] << " [-n queries] image..." << std::endl;
+    return 1;
+  }
+
+  Lookup::sharedCollisionLookup("collision_lookup.bin");
+  CollisionDetection configurationSpace;
+  HeadingLayers layers;
+  DynamicVoronoi voronoi;
+
+  for (const std::string& file : images) {
+    cv::Mat gridmap = cv::imread(file, cv::IMREAD_COLOR);
+
+    if (gridmap.empty()) {
+      std::cerr << "could not read " << file << std::endl;
+      continue;
+    }
+
+    configurationSpace.updateGrid(gridmap);
+    const BinaryGrid& grid = configurationSpace.getGrid();
+    voronoi.initializeMap(grid);
+    voronoi.update();
+    configurationSpace.updateDistanceMap(&voronoi);
+
+    // the dilation, repeated to average out the timer
+    const int repetitions = 10;
+    double t0 = Clock::now();
+
+    for (int r = 0; r < repetitions; ++r) { layers.update(grid); }
+
+    double dilation = (Clock::now() - t0) / repetitions;
+
+    // the same random configurations on the map for both tests
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> x(0, grid.getSizeX()), y(0, grid.getSizeY()), t(0, 2 * M_PI);
+    std::vector<float> configurations(3 * queries);
+
+    for (int i = 0; i < queries; ++i) {
+      configurations[3 * i] = x(rng);
+      configurations[3 * i + 1] = y(rng);
+      configurations[3 * i + 2] = t(rng);
+    }
+
+    int footprintFree = 0;
+    t0 = Clock::now();
+
+    for (int i = 0; i < queries; ++i) {
+      const float* q = &configurations[3 * i];
+      footprintFree += configurationSpace.configurationTest(q[0], q[1], q[2]);
+    }
+
+    double footprint = (Clock::now() - t0) / queries;
+    int layerFree = 0, conservative = 0;
+    t0 = Clock::now();
+
+    for (int i = 0; i < queries; ++i) {
+      const float* q = &configurations[3 * i];
+      layerFree += !layers.isBlocked((int)q[0], (int)q[1], (int)(q[2] / Parameters::deltaHeading()));
+    }
+
+    double lookup = (Clock::now() - t0) / queries;
+    sink = footprintFree + layerFree;
+
+    for (int i = 0; i < queries; ++i) {
+      const float* q = &configurations[3 * i];
+      conservative += configurationSpace.configurationTest(q[0], q[1], q[2])
+                      && layers.isBlocked((int)q[0], (int)q[1], (int)(q[2] / Parameters::deltaHeading()));
+    }
+
+    std::cout << file << " (" << grid.getSizeX() << "x" << grid.getSizeY() << ")" << std::endl;
+    std::cout << "  dilation        [ms]: " << dilation * 1e3 << std::endl;
+    std::cout << "  footprint test  [ns]: " << footprint * 1e9 << std::endl;
+    std::cout << "  layer lookup    [ns]: " << lookup * 1e9 << std::endl;
+    std::cout << "  break-even [tests/map]: ";
+
+    if (footprint > lookup) {
+      std::cout << (long)(dilation / (footprint - lookup)) << std::endl;
+    } else {
+      std::cout << "never" << std::endl;
+    }
+
+    std::cout << "  conservative     [%]: " << 100.0 * conservative / queries << " of the tests, "
+              << 100.0 * conservative / (footprintFree ? footprintFree : 1) << " of the free configurations" << std::endl;
+  }
+
+  return 0;
+}
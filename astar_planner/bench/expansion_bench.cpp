@@ -0,0 +1,73 @@
+/*!
+   \file expansion_bench.cpp
+   \brief Measures the successor generation rate of the 2D and 3D nodes.
+
+   The heap variant calls the allocating createSuccessor and deletes every successor like the search formerly did,
+   the scratch variant writes every successor into one caller owned node as the search does now.
+*/
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include "constants.h"
+#include "node2d.h"
+#include "node3d.h"
+#include "parameters.h"
+
+using namespace HybridAStar;
+
+typedef std::chrono::steady_clock Clock;
+
+/// keeps the compiler from discarding the generated successors
+static volatile float sink;
+
+template<typename T> double rate(int expansions, int dir, T* preds, int n, bool heap) {
+  T scratch;
+  float acc = 0;
+  Clock::time_point t0 = Clock::now();
+
+  for (int e = 0; e < expansions; ++e) {
+    T* pred = &preds[e % n];
+
+    for (int i = 0; i < dir; ++i) {
+      if (heap) {
+        T* succ = pred->createSuccessor(i);
+        acc += succ->getX();
+        delete succ;
+      } else {
+        T* succ = pred->createSuccessor(i, &scratch);
+        acc += succ->getX();
+      }
+    }
+  }
+
+  double s = std::chrono::duration<double>(Clock::now() - t0).count();
+  sink = acc;
+  return expansions / s;
+}
+
+int main(int argc, char** argv) {
+  // the iteration budget of a single plan by default
+  int expansions = argc > 1 ? std::atoi(argv[1]) : 100 * Constants::iterations;
+  const int n = 1024;
+  const int dir = Constants::reverse ? 6 : 3;
+
+  Node3D* nodes3D = new Node3D[n];
+  Node2D* nodes2D = new Node2D[n];
+  std::srand(42);
+
+  for (int i = 0; i < n; ++i) {
+    nodes3D[i] = Node3D(std::rand() % 200, std::rand() % 200, Parameters::get().deltaHeadingRad() * (std::rand() % Parameters::get().headings), 0, 0, nullptr);
+    nodes2D[i] = Node2D(std::rand() % 200, std::rand() % 200, 0, 0, nullptr);
+  }
+
+  std::cout << "expansions per run: " << expansions << std::endl;
+  std::cout << "Node3D heap    [exp/s]: " << rate(expansions, dir, nodes3D, n, true) << std::endl;
+  std::cout << "Node3D scratch [exp/s]: " << rate(expansions, dir, nodes3D, n, false) << std::endl;
+  std::cout << "Node2D heap    [exp/s]: " << rate(expansions, Node2D::dir, nodes2D, n, true) << std::endl;
+  std::cout << "Node2D scratch [exp/s]: " << rate(expansions, Node2D::dir, nodes2D, n, false) << std::endl;
+
+  delete [] nodes3D;
+  delete [] nodes2D;
+  return 0;
+}
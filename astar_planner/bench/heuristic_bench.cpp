@@ -0,0 +1,140 @@
+/*!
+   \file heuristic_bench.cpp
+   \brief Compares the closed form Dubin's and Reeds-Shepp kernels with the OMPL state spaces.
+
+   For random pose pairs it reports the largest absolute difference of the distances, the time per call
+   and the number of heap allocations that were not released again.
+   The OMPL variant reproduces the former `updateH`, which allocated two states per call and never freed them.
+   The bench fails if a kernel differs from OMPL by more than the tolerance or leaks an allocation.
+*/
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+
+#include <ompl/base/spaces/DubinsStateSpace.h>
+#include <ompl/base/spaces/ReedsSheppStateSpace.h>
+#include <ompl/base/spaces/SE2StateSpace.h>
+
+#include "constants.h"
+#include "heuristic.h"
+
+using namespace HybridAStar;
+
+typedef std::chrono::steady_clock Clock;
+typedef ompl::base::SE2StateSpace::StateType State;
+
+/// the number of live heap allocations, counted by the replaced global operators below
+static long live = 0;
+
+void* operator new(std::size_t size) {
+  void* p = std::malloc(size ? size : 1);
+
+  if (!p) { throw std::bad_alloc(); }
+
+  ++live;
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  if (p) { --live; }
+
+  std::free(p);
+}
+
+/// keeps the compiler from discarding the distances
+static volatile float sink;
+
+/// the largest accepted absolute difference to the OMPL distances, a thousandth of a cell
+static const float tolerance = 1e-3f;
+
+/// a set of start poses and a goal pose
+struct Poses {
+  std::vector<float> x, y, t;
+  float x1, y1, t1;
+};
+
+/// the former updateH path, allocating two states per call without freeing them
+template<typename Space> float omplCost(float x0, float y0, float t0, float x1, float y1, float t1) {
+  Space space(Constants::r);
+  State* start = (State*)space.allocState();
+  State* end = (State*)space.allocState();
+  start->setXY(x0, y0);
+  start->setYaw(t0);
+  end->setXY(x1, y1);
+  end->setYaw(t1);
+  return space.distance(start, end);
+}
+
+template<typename Space> bool report(const char* name, const Poses& p, float (*kernel)(float, float, float, float, float, float, float),
+                                     void (*batch)(const float*, const float*, const float*, int, float, float, float, float*, float)) {
+  const int n = p.x.size();
+  std::vector<float> reference(n), closed(n), batched(n);
+
+  long before = live;
+  Clock::time_point t0 = Clock::now();
+
+  for (int i = 0; i < n; ++i) { reference[i] = omplCost<Space>(p.x[i], p.y[i], p.t[i], p.x1, p.y1, p.t1); }
+
+  double omplTime = std::chrono::duration<double>(Clock::now() - t0).count();
+  long omplLeaked = live - before;
+
+  before = live;
+  t0 = Clock::now();
+
+  for (int i = 0; i < n; ++i) { closed[i] = kernel(p.x[i], p.y[i], p.t[i], p.x1, p.y1, p.t1, Constants::r); }
+
+  double kernelTime = std::chrono::duration<double>(Clock::now() - t0).count();
+  t0 = Clock::now();
+  batch(p.x.data(), p.y.data(), p.t.data(), n, p.x1, p.y1, p.t1, batched.data(), Constants::r);
+  double batchTime = std::chrono::duration<double>(Clock::now() - t0).count();
+  long kernelLeaked = live - before;
+
+  float maxDiff = 0;
+  float acc = 0;
+
+  for (int i = 0; i < n; ++i) {
+    maxDiff = std::max(maxDiff, std::fabs(reference[i] - closed[i]));
+    maxDiff = std::max(maxDiff, std::fabs(reference[i] - batched[i]));
+    acc += closed[i];
+  }
+
+  sink = acc;
+
+  std::cout << name << "\n"
+            << "  max abs difference   " << maxDiff << "\n"
+            << "  ompl    ns/call      " << omplTime * 1e9 / n << "  leaked allocations " << omplLeaked << "\n"
+            << "  kernel  ns/call      " << kernelTime * 1e9 / n << "  leaked allocations " << kernelLeaked << "\n"
+            << "  batched ns/call      " << batchTime * 1e9 / n << std::endl;
+
+  return maxDiff <= tolerance && kernelLeaked == 0;
+}
+
+int main(int argc, char** argv) {
+  int n = argc > 1 ? std::atoi(argv[1]) : 100000;
+  Poses p;
+  std::srand(42);
+
+  // random poses within a map of the default size around a fixed goal
+  for (int i = 0; i < n; ++i) {
+    p.x.push_back(std::rand() % 20000 / 100.f);
+    p.y.push_back(std::rand() % 20000 / 100.f);
+    p.t.push_back(std::rand() % 36000 / 36000.f * 2 * M_PI);
+  }
+
+  p.x1 = 100;
+  p.y1 = 100;
+  p.t1 = M_PI / 3;
+
+  bool ok = report<ompl::base::DubinsStateSpace>("Dubin's", p, Heuristic::dubinsCost, Heuristic::dubinsCost);
+  ok = report<ompl::base::ReedsSheppStateSpace>("Reeds-Shepp", p, Heuristic::reedsSheppCost, Heuristic::reedsSheppCost) && ok;
+
+  if (!ok) {
+    std::cerr << "a kernel differs by more than " << tolerance << " or leaks allocations" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,132 @@
+/*!
+   \file planner_bench.cpp
+   \brief Measures the plan rate and latency of the planner core on occupancy images loaded from disk.
+
+   Every image is planned on repeatedly from scratch, the replanner is reset before each plan.
+   The start and goal default to the poses of the node, the bottom and the top center of the map facing up.
+   The images are read in the channel order the map generator draws, publishes and records the maps in, an obstacle is 255 in the first channel.
+
+   usage: planner_bench [-n repetitions] [--start x y t] [--goal x y t] [--lookup file] image...
+*/
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "opencv2/opencv.hpp"
+
+#include "clock.h"
+#include "constants.h"
+#include "lookup.h"
+#include "planner.h"
+#include "stats.h"
+
+using namespace HybridAStar;
+
+/// returns the p-quantile of the sorted samples
+static double quantile(const std::vector<double>& sorted, double p) {
+  if (sorted.empty()) { return 0; }
+
+  int i = std::min((int)sorted.size() - 1, (int)std::ceil(p * sorted.size()) - 1);
+  return sorted[std::max(0, i)];
+}
+
+int main(int argc, char** argv) {
+  int repetitions = 20;
+  bool customStart = false, customGoal = false;
+  float start[3], goal[3];
+  std::string lookup;
+  std::vector<std::string> images;
+
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "-n") && i + 1 < argc) {
+      repetitions = std::atoi(argv[++i]);
+    } else if (!std::strcmp(argv[i], "--start") && i + 3 < argc) {
+      for (int j = 0; j < 3; ++j) { start[j] = std::atof(argv[++i]); }
+
+      customStart = true;
+    } else if (!std::strcmp(argv[i], "--goal") && i + 3 < argc) {
+      for (int j = 0; j < 3; ++j) { goal[j] = std::atof(argv[++i]); }
+
+      customGoal = true;
+    } else if (!std::strcmp(argv[i], "--lookup") && i + 1 < argc) {
+      lookup = argv[++i];
+    } else {
+      images.push_back(argv[i]);
+    }
+  }
+
+  if (images.empty()) {
+    std::cerr << "usage: " << argv[0] << " [-n repetitions] [--start x y t] [--goal x y t] [--lookup file] image..." << std::endl;
+    return 1;
+  }
+
+  Lookup::sharedCollisionLookup("collision_lookup.bin");
+  Planner planner;
+
+  if (Constants::dubinsLookup) { planner.initializeDubinsLookup(lookup.empty() ? "dubins_lookup.bin" : lookup); }
+
+  std::vector<double> latencies;
+  double mapTime = 0;
+  int found = 0;
+#ifdef ASTAR_PLANNER_STATS
+  long long expansions = 0;
+  double searchTime = 0;
+#endif
+
+  for (const std::string& file : images) {
+    cv::Mat gridmap = cv::imread(file, cv::IMREAD_COLOR);
+
+    if (gridmap.empty()) {
+      std::cerr << "could not read " << file << std::endl;
+      continue;
+    }
+
+    // the map generator stores the maps in the channel order the planner reads them, the first channel marks the obstacles
+    double t0 = Clock::now();
+
+    if (!planner.updateMap(gridmap)) { continue; }
+
+    mapTime += Clock::now() - t0;
+
+    for (int r = 0; r < repetitions; ++r) {
+      Node3D nStart = customStart ? Node3D(start[0], start[1], start[2], 0, 0, nullptr)
+                                  : Node3D(gridmap.rows - 1, gridmap.cols / 2, M_PI, 0, 0, nullptr);
+      const Node3D nGoal = customGoal ? Node3D(goal[0], goal[1], goal[2], 0, 0, nullptr)
+                                      : Node3D(1, gridmap.cols / 2, M_PI, 0, 0, nullptr);
+      planner.getReplanner().reset();
+      PlannerStats::current.reset();
+
+      t0 = Clock::now();
+      found += planner.plan(nStart, nGoal);
+      latencies.push_back(Clock::now() - t0);
+#ifdef ASTAR_PLANNER_STATS
+      expansions += PlannerStats::current.expansions;
+      searchTime += PlannerStats::current.searchTime / 1000;
+#endif
+    }
+  }
+
+  if (latencies.empty()) { return 1; }
+
+  double total = 0;
+
+  for (double latency : latencies) { total += latency; }
+
+  std::sort(latencies.begin(), latencies.end());
+
+  std::cout << "maps: " << images.size() << ", plans: " << latencies.size() << ", found: " << found << std::endl;
+  std::cout << "map update [ms]: " << 1000 * mapTime / images.size() << std::endl;
+  std::cout << "plans/s: " << latencies.size() / total << std::endl;
+  std::cout << "latency p50 [ms]: " << 1000 * quantile(latencies, 0.5) << std::endl;
+  std::cout << "latency p99 [ms]: " << 1000 * quantile(latencies, 0.99) << std::endl;
+#ifdef ASTAR_PLANNER_STATS
+  std::cout << "expansions/s: " << (searchTime > 0 ? expansions / searchTime : 0) << std::endl;
+#else
+  std::cout << "expansions/s: n/a, configure with ASTAR_PLANNER_STATS=ON to count them" << std::endl;
+#endif
+  return 0;
+}
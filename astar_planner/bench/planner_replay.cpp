@@ -0,0 +1,282 @@
+/*!
+   \file planner_replay.cpp
+   \brief Replays recorded occupancy maps through the planner core and reports the latency of every frame.
+
+   The frames are decoded from the recordings of the map generator (`map_generator/data/map.avi`) or read from a PNG sequence,
+   scaled back to the size of the map and planned on one after the other, exactly as the node does on every map it receives:
+   Voronoi diagram, hybrid A* and smoothing. Without ROS in the loop the replay is deterministic up to the deadline of the anytime search.
+
+   The recorder writes the maps in the channel order the planner reads them, an obstacle is 255 in the first channel.
+   As the video codec is lossy the frames are binarized again before they are planned on.
+
+   usage: planner_replay [--config system_config.yaml] [--deadline s] [--incremental] [--voronoi mode] [--change-share share]
+                         [--csv file] [--budget ms] recording...
+
+   The report is a CSV line per frame on the standard output or in the file given by --csv, the summary goes to the standard error.
+   A recording is a video file, a directory of PNG files or a glob pattern matching PNG files.
+   With --budget the exit status is 2 if the p99 latency of the frames exceeds the budget, so the replay can gate a regression.
+   --voronoi selects how the distance map follows the maps (brushfire, exact, incremental or lazy, see Constants::VoronoiMode),
+   --change-share the share of changed cells up to which the incremental mode updates instead of rebuilding.
+   Together with the share of the cells that changed since the previous frame in the report, they tune Constants::voronoiChangeShare.
+*/
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "opencv2/opencv.hpp"
+
+#include "binarygrid.h"
+#include "clock.h"
+#include "constants.h"
+#include "lookup.h"
+#include "parameters.h"
+#include "planner.h"
+#include "stats.h"
+
+using namespace HybridAStar;
+
+/// returns the p-quantile of the sorted samples
+static double quantile(const std::vector<double>& sorted, double p) {
+  if (sorted.empty()) { return 0; }
+
+  int i = std::min((int)sorted.size() - 1, (int)std::ceil(p * sorted.size()) - 1);
+  return sorted[std::max(0, i)];
+}
+
+/// parses the name of a distance map mode, returns false for an unknown name
+static bool parseVoronoiMode(const char* name, Constants::VoronoiMode& mode) {
+  const char* names[] = {"brushfire", "exact", "incremental", "lazy"};
+  const Constants::VoronoiMode modes[] = {Constants::VoronoiMode::brushfire, Constants::VoronoiMode::exact,
+                                          Constants::VoronoiMode::incremental, Constants::VoronoiMode::lazy};
+
+  for (int i = 0; i < 4; ++i) {
+    if (!std::strcmp(name, names[i])) {
+      mode = modes[i];
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/// scales the frame to the size of the map and restores the binary occupancy the codec blurred
+static void normalize(const cv::Mat& frame, int width, int height, cv::Mat& gridmap) {
+  cv::resize(frame, gridmap, cv::Size(width, height), 0, 0, cv::INTER_NEAREST);
+
+  for (int x = 0; x < gridmap.rows; ++x) {
+    for (int y = 0; y < gridmap.cols; ++y) {
+      cv::Vec3b& px = gridmap.at<cv::Vec3b>(x, y);
+      px[0] = px[0] > 127 ? 255 : 0;
+    }
+  }
+}
+
+/// the frames of a video, a directory of PNG files or a glob pattern, decoded one at a time
+class Recording {
+ public:
+  explicit Recording(const std::string& recording) {
+    bool png = recording.size() > 4 && recording.compare(recording.size() - 4, 4, ".png") == 0;
+
+    if (png || recording.find('*') != std::string::npos) {
+      cv::glob(recording, files, false);
+    } else if (!video.open(recording)) {
+      // not a video, try it as a directory of images
+      cv::glob(recording + "/*.png", files, false);
+    }
+  }
+
+  /// whether there are frames to read
+  bool isOpened() const { return video.isOpened() || !files.empty(); }
+
+  /// reads the next frame, the glob is sorted, so numbered images replay in order
+  bool read(cv::Mat& frame) {
+    if (video.isOpened()) { return video.read(frame); }
+
+    while (next < files.size()) {
+      frame = cv::imread(files[next++], cv::IMREAD_COLOR);
+
+      if (!frame.empty()) { return true; }
+    }
+
+    return false;
+  }
+
+ private:
+  cv::VideoCapture video;
+  std::vector<cv::String> files;
+  size_t next = 0;
+};
+
+int main(int argc, char** argv) {
+  std::string config;
+  std::string csv;
+  double deadline = -1;
+  double budget = -1;
+  double changeShare = -1;
+  bool incremental = false;
+  Constants::VoronoiMode voronoiMode = Constants::voronoiMode;
+  std::vector<std::string> recordings;
+
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "--config") && i + 1 < argc) {
+      config = argv[++i];
+    } else if (!std::strcmp(argv[i], "--deadline") && i + 1 < argc) {
+      deadline = std::atof(argv[++i]);
+    } else if (!std::strcmp(argv[i], "--budget") && i + 1 < argc) {
+      budget = std::atof(argv[++i]);
+    } else if (!std::strcmp(argv[i], "--csv") && i + 1 < argc) {
+      csv = argv[++i];
+    } else if (!std::strcmp(argv[i], "--incremental")) {
+      incremental = true;
+    } else if (!std::strcmp(argv[i], "--voronoi") && i + 1 < argc) {
+      if (!parseVoronoiMode(argv[++i], voronoiMode)) {
+        std::cerr << "unknown mode " << argv[i] << ", expected brushfire, exact, incremental or lazy" << std::endl;
+        return 1;
+      }
+    } else if (!std::strcmp(argv[i], "--change-share") && i + 1 < argc) {
+      changeShare = std::atof(argv[++i]);
+    } else {
+      recordings.push_back(argv[i]);
+    }
+  }
+
+  if (recordings.empty()) {
+    std::cerr << "usage: " << argv[0]
+              << " [--config system_config.yaml] [--deadline s] [--incremental] [--voronoi mode] [--change-share share]"
+              << " [--csv file] [--budget ms] recording..." << std::endl;
+    return 1;
+  }
+
+  // the map size and the deadline of the node
+  int width = 200;
+  int height = 200;
+  double configDeadline = 0;
+  Parameters parameters;
+
+  if (!config.empty()) {
+    cv::FileStorage params_config(config, cv::FileStorage::READ);
+
+    if (!params_config.isOpened()) {
+      std::cerr << "could not read " << config << std::endl;
+      return 1;
+    }
+
+    width = params_config["Map.width"];
+    height = params_config["Map.height"];
+
+    if (!params_config["Path.deadline"].empty()) { configDeadline = (double)params_config["Path.deadline"]; }
+
+    if (!parameters.load(config)) { return 1; }
+  }
+
+  // the footprint and heading resolution have to be set before the lookups are built
+  if (!Parameters::set(parameters)) { return 1; }
+
+  Lookup::sharedCollisionLookup("collision_lookup.bin");
+  Planner planner;
+
+  if (configDeadline > 0) { planner.deadline = configDeadline; }
+
+  if (deadline > 0) { planner.deadline = deadline; }
+
+  if (changeShare >= 0) { planner.voronoiChangeShare = changeShare; }
+
+  planner.voronoiMode = voronoiMode;
+
+  if (Constants::dubinsLookup) { planner.initializeDubinsLookup("dubins_lookup.bin"); }
+
+  std::ofstream out;
+
+  if (!csv.empty()) { out.open(csv.c_str()); }
+
+  // the report goes to the console or the file, the debug output of the planner is silenced
+  std::ostream console(std::cout.rdbuf());
+  std::ostream& report = out.is_open() ? out : console;
+  std::cout.rdbuf(nullptr);
+  report << "recording,frame,found,path_length,path_cost,bound,map_ms,plan_ms,total_ms,changed";
+#ifdef ASTAR_PLANNER_STATS
+  report << ",expansions";
+#endif
+  report << "\n";
+
+  // the start and the goal of the node without ego-motion, the goal is the target of the map generator
+  const Node3D nGoal(1, width / 2, M_PI, 0, 0, nullptr);
+  std::vector<double> latencies;
+  std::vector<double> mapLatencies;
+  double total = 0;
+  int found = 0;
+
+  for (const std::string& recording : recordings) {
+    Recording frames(recording);
+
+    if (!frames.isOpened()) {
+      std::cerr << "could not read " << recording << std::endl;
+      continue;
+    }
+
+    // every recording starts from scratch
+    planner.getReplanner().reset();
+    cv::Mat frame, gridmap;
+    // the grid of the previous frame, the share of the cells that changed since is reported per frame
+    BinaryGrid previous;
+    std::vector<BinaryGrid::Change> changes;
+
+    for (int f = 0; frames.read(frame); ++f) {
+      normalize(frame, width, height, gridmap);
+      PlannerStats::current.reset();
+
+      if (!incremental) { planner.getReplanner().reset(); }
+
+      Node3D nStart(height - 1, width / 2, M_PI, 0, 0, nullptr);
+      double t0 = Clock::now();
+      planner.updateMap(gridmap);
+      double t1 = Clock::now();
+      bool solved = planner.plan(nStart, nGoal);
+      double t2 = Clock::now();
+
+      found += solved;
+      latencies.push_back(t2 - t0);
+      mapLatencies.push_back(t1 - t0);
+      total += t2 - t0;
+
+      // a change of the size of the map counts as a change of every cell
+      const BinaryGrid& grid = planner.getConfigurationSpace().getGrid();
+      double changed = grid.changes(previous, width * height, changes) ? (double)changes.size() / (width * height) : 1;
+      previous = grid;
+
+      report << recording << ',' << f << ',' << solved << ',' << planner.getPath().size() << ','
+             << (solved ? planner.getPath().front().getG() : 0) << ',' << (solved ? planner.getBound() : 0) << ','
+             << 1000 * (t1 - t0) << ',' << 1000 * (t2 - t1) << ',' << 1000 * (t2 - t0) << ',' << changed;
+#ifdef ASTAR_PLANNER_STATS
+      report << ',' << PlannerStats::current.expansions;
+#endif
+      report << "\n";
+    }
+  }
+
+  if (latencies.empty()) { return 1; }
+
+  std::sort(latencies.begin(), latencies.end());
+  std::sort(mapLatencies.begin(), mapLatencies.end());
+  double p99 = 1000 * quantile(latencies, 0.99);
+
+  std::cerr << "frames: " << latencies.size() << ", found: " << found << std::endl;
+  std::cerr << "frames/s: " << latencies.size() / total << std::endl;
+  std::cerr << "latency p50 [ms]: " << 1000 * quantile(latencies, 0.5) << std::endl;
+  std::cerr << "latency p99 [ms]: " << p99 << std::endl;
+  std::cerr << "latency max [ms]: " << 1000 * latencies.back() << std::endl;
+  std::cerr << "map update p50 [ms]: " << 1000 * quantile(mapLatencies, 0.5) << std::endl;
+  std::cerr << "map update p99 [ms]: " << 1000 * quantile(mapLatencies, 0.99) << std::endl;
+
+  if (budget > 0 && p99 > budget) {
+    std::cerr << "p99 latency exceeds the budget of " << budget << " ms" << std::endl;
+    return 2;
+  }
+
+  return 0;
+}
@@ -0,0 +1,105 @@
+/*!
+   \file voronoi_bench.cpp
+   \brief Compares the brushfire of DynamicVoronoi::update with the exact distance transform of DynamicVoronoi::updateExact.
+
+   For every map size a random map of obstacle blobs is rebuilt with both and the best time of a few repetitions is reported,
+   the exact transform once for every number of threads.
+   The cells whose distances differ are counted, the brushfire is exact for almost every cell,
+   as are the cells on the Voronoi diagram in one but not the other, which differ where the closest obstacles tie.
+
+   usage: voronoi_bench [-t threads] [-d density] size...
+*/
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "binarygrid.h"
+#include "clock.h"
+#include "dynamicvoronoi.h"
+#include "threadpool.h"
+
+#include "opencv2/opencv.hpp"
+
+using namespace HybridAStar;
+
+int main(int argc, char** argv) {
+  int maxThreads = 0;
+  float density = 0.02;
+  std::vector<int> sizes;
+
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "-t") && i + 1 < argc) {
+      maxThreads = std::atoi(argv[++i]);
+    } else if (!std::strcmp(argv[i], "-d") && i + 1 < argc) {
+      density = std::atof(argv[++i]);
+    } else {
+      sizes.push_back(std::atoi(argv[i]));
+    }
+  }
+
+  if (sizes.empty()) { sizes = {200, 400, 800, 1600}; }
+
+  if (maxThreads <= 0) { maxThreads = std::max(1u, std::thread::hardware_concurrency()); }
+
+  const int repetitions = 5;
+
+  for (int size : sizes) {
+    // blobs of up to 5x5 cells covering about the density of the map
+    std::mt19937 rng(size);
+    cv::Mat gridmap(size, size, CV_8UC3, cv::Scalar(0, 0, 0));
+
+    for (int blob = 0; blob < density * size * size / 9; ++blob) {
+      int x = rng() % size, y = rng() % size, r = rng() % 3;
+
+      for (int i = std::max(0, x - r); i <= std::min(size - 1, x + r); ++i) {
+        for (int j = std::max(0, y - r); j <= std::min(size - 1, y + r); ++j) { gridmap.at<cv::Vec3b>(i, j)[0] = 255; }
+      }
+    }
+
+    BinaryGrid grid;
+    grid.update(gridmap);
+    DynamicVoronoi brushfire, exact;
+    double best = 1e9;
+
+    for (int r = 0; r < repetitions; ++r) {
+      double t0 = Clock::now();
+      brushfire.initializeMap(grid);
+      brushfire.update();
+      best = std::min(best, Clock::now() - t0);
+    }
+
+    std::cout << size << "x" << size << std::endl;
+    std::cout << "  brushfire           [ms]: " << best * 1e3 << std::endl;
+
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+      ThreadPool pool(threads);
+      best = 1e9;
+
+      for (int r = 0; r < repetitions; ++r) {
+        double t0 = Clock::now();
+        exact.initializeMap(grid);
+        exact.updateExact(pool);
+        best = std::min(best, Clock::now() - t0);
+      }
+
+      std::cout << "  exact, " << threads << " thread(s) [ms]: " << best * 1e3 << std::endl;
+    }
+
+    long distances = 0, voronoi = 0;
+
+    for (int x = 0; x < size; ++x) {
+      for (int y = 0; y < size; ++y) {
+        distances += brushfire.cell(x, y).sqdist != exact.cell(x, y).sqdist;
+        voronoi += brushfire.isVoronoi(x, y) != exact.isVoronoi(x, y);
+      }
+    }
+
+    std::cout << "  differing distances  [%]: " << 100.0 * distances / (size * size) << std::endl;
+    std::cout << "  differing diagram    [%]: " << 100.0 * voronoi / (size * size) << std::endl;
+  }
+
+  return 0;
+}
@@ -1,17 +1,13 @@
 #ifndef ALGORITHM_H
 #define ALGORITHM_H
 
-#include <ompl/base/spaces/ReedsSheppStateSpace.h>
-#include <ompl/base/spaces/DubinsStateSpace.h>
-#include <ompl/base/spaces/SE2StateSpace.h>
-#include <ompl/base/State.h>
-
-typedef ompl::base::SE2StateSpace::StateType State;
+#include <vector>
 
 #include "node3d.h"
 #include "node2d.h"
 //#include "visualize.h"
 #include "collisiondetection.h"
+#include "openlist.h"
 
 namespace HybridAStar {
 
@@ -19,6 +15,21 @@ class Node3D;
 class Node2D;
 class Visualize;
 
+/*!
+   \brief The open lists and the nodes of the Dubin's shot a search works in.
+
+   It is owned by the caller next to its node arrays, so that the storage is reused across searches
+   while planners on different threads do not share any state.
+*/
+struct SearchContext {
+  /// the open list of the hybrid A*
+  OpenList<Node3D>::type open3D;
+  /// the open list of the 2D A* and of the cost-to-goal field
+  OpenList<Node2D>::type open2D;
+  /// the nodes of the last Dubin's shot, valid until the next shot
+  std::vector<Node3D> dubinsNodes;
+};
+
 /*!
  * \brief A class that encompasses the functions central to the search.
  */
@@ -35,10 +46,11 @@ class Algorithm {
      \param goal the goal pose
      \param nodes3D the array of 3D nodes representing the configuration space C in R^3
      \param nodes2D the array of 2D nodes representing the configuration space C in R^2
+     \param context the open lists and the Dubin's shot storage of the search
      \param width the width of the grid in number of cells
      \param height the height of the grid in number of cells
      \param configurationSpace the lookup of configurations and their spatial occupancy enumeration
-     \param dubinsLookup the lookup of analytical solutions (Dubin's paths)
+     \param dubinsLookup the lookup of analytical solutions (Dubin's paths), nullptr uses the closed form kernel
      \param visualization the visualization object publishing the search to RViz
      \return the pointer to the node satisfying the goal condition
   */
@@ -46,11 +58,67 @@ class Algorithm {
                              const Node3D& goal,
                              Node3D* nodes3D,
                              Node2D* nodes2D,
+                             SearchContext& context,
                              int width,
                              int height,
                              CollisionDetection& configurationSpace,
                              float* dubinsLookup);
 
+  // ANYTIME HYBRID A* ALGORITHM
+  /*!
+     \brief The anytime variant of the hybrid A*, returning the best path found within a wall clock budget.
+
+     It restarts weighted searches with the heuristic inflated by Constants::inflation, decreasing it by Constants::inflationStep
+     after every search, until a search without inflation completes or the deadline has passed.
+     Each search prunes the nodes that cannot improve on the cost of the best path found so far.
+
+     \param start the start pose
+     \param goal the goal pose
+     \param nodes3D the array of 3D nodes representing the configuration space C in R^3
+     \param nodes2D the array of 2D nodes representing the configuration space C in R^2
+     \param context the open lists and the Dubin's shot storage of the search
+     \param width the width of the grid in number of cells
+     \param height the height of the grid in number of cells
+     \param configurationSpace the lookup of configurations and their spatial occupancy enumeration
+     \param dubinsLookup the lookup of analytical solutions (Dubin's paths), nullptr uses the closed form kernel
+     \param deadline [s] the wall clock budget of the plan
+     \param path the best path found, starting at the goal like Smoother::tracePath
+     \param bound the suboptimality bound of the path, the inflation of the last search that completed
+     \return whether a path has been found
+  */
+  static bool anytimeHybridAStar(Node3D& start,
+                                 const Node3D& goal,
+                                 Node3D* nodes3D,
+                                 Node2D* nodes2D,
+                                 SearchContext& context,
+                                 int width,
+                                 int height,
+                                 CollisionDetection& configurationSpace,
+                                 float* dubinsLookup,
+                                 double deadline,
+                                 std::vector<Node3D>& path,
+                                 float& bound);
+
+  /*!
+     \brief Plans from scratch with the anytime or the single hybrid A* depending on Constants::anytime
+
+     \param path the path found, starting at the goal like Smoother::tracePath
+     \param bound the suboptimality bound of the path, 1 for the single search
+     \return whether a path has been found
+  */
+  static bool search(Node3D& start,
+                     const Node3D& goal,
+                     Node3D* nodes3D,
+                     Node2D* nodes2D,
+                     SearchContext& context,
+                     int width,
+                     int height,
+                     CollisionDetection& configurationSpace,
+                     float* dubinsLookup,
+                     double deadline,
+                     std::vector<Node3D>& path,
+                     float& bound);
+
 };
 }
 #endif // ALGORITHM_H
@@ -0,0 +1,99 @@
+#ifndef BINARYGRID_H
+#define BINARYGRID_H
+
+#include <cstdint>
+#include <vector>
+
+#include "constants.h"
+
+namespace cv {
+class Mat;
+}
+
+namespace HybridAStar {
+/*!
+   \brief A bit-packed occupancy grid, converted once per map from the occupancy image.
+
+   A cell (x,y) is the pixel in row x and column y of the image, it is occupied if the first channel of the pixel is 255.
+   Every row is stored in 64 bit words, padded with an empty word on either side and
+   as many empty rows above and below as the bounding box of the footprints spans, so a footprint near the edge of the map can be tested without bounds checks.
+   The cells beyond the map are free, just as the footprint test of the collision lookup ignores them.
+*/
+class BinaryGrid {
+ public:
+  /// The default constructor creating an empty grid
+  BinaryGrid() {}
+
+  /// converts the occupancy image into the grid
+  void update(const cv::Mat& gridmap);
+
+  /// returns the number of rows of the map
+  int getSizeX() const { return sizeX; }
+  /// returns the number of columns of the map
+  int getSizeY() const { return sizeY; }
+
+  /// returns whether the cell is occupied, cells beyond the map are free
+  bool isOccupied(int x, int y) const {
+    if (x < 0 || x >= sizeX || y < 0 || y >= sizeY) { return false; }
+
+    int bit = y + wordBits;
+    return (row(x)[bit / wordBits] >> (bit % wordBits)) & 1;
+  }
+
+  /*!
+     \brief Returns the 64 cells of a row starting at a column, the cell (x,y) in the lowest bit
+
+     The row has to be within the padding of the grid, the columns within the padded words.
+  */
+  uint64_t cells(int x, int y) const {
+    const uint64_t* words = row(x);
+    int bit = y + wordBits;
+    int shift = bit % wordBits;
+    words += bit / wordBits;
+    return shift ? (words[0] >> shift) | (words[1] << (wordBits - shift)) : words[0];
+  }
+
+  /// whether 64 cells starting at the column can be read from the row without leaving the padding
+  bool isPadded(int x, int y) const {
+    return x >= -padRows && x < sizeX + padRows && y >= -wordBits && y + wordBits < (stride - 1) * wordBits;
+  }
+
+  /// the number of bits of a word
+  static const int wordBits = 64;
+
+  /// A cell that changed between two grids
+  struct Change {
+    /// the row of the cell
+    int x;
+    /// the column of the cell
+    int y;
+    /// whether the cell is occupied now
+    bool occupied;
+  };
+
+  /*!
+     \brief Collects the cells that changed since a previous grid, comparing 64 cells at a time
+     \param previous the previous grid
+     \param limit the maximum number of changes worth collecting
+     \param changes set to the changed cells
+     \return false if the grids differ in size or in more than limit cells, else true
+  */
+  bool changes(const BinaryGrid& previous, int limit, std::vector<Change>& changes) const;
+
+ private:
+  /// returns the words of a row, including the padding word on the left
+  const uint64_t* row(int x) const { return &words[(x + padRows) * stride]; }
+
+  /// the number of rows of the map
+  int sizeX = 0;
+  /// the number of columns of the map
+  int sizeY = 0;
+  /// the number of words of a row including the padding
+  int stride = 0;
+  /// the number of empty rows above and below the map
+  int padRows = 0;
+  /// the rows of the grid
+  std::vector<uint64_t> words;
+};
+}
+#endif // BINARYGRID_H
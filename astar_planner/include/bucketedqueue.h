@@ -1,12 +1,8 @@
 #ifndef _PRIORITYQUEUE2_H_
 #define _PRIORITYQUEUE2_H_
 
-#define MAXDIST 1000
-#define RESERVE 64
-
+#include <stdint.h>
 #include <vector>
-#include <set>
-#include <queue>
 #include <assert.h>
 #include "point.h"
 
@@ -15,32 +11,68 @@ namespace HybridAStar {
 /** A priority queue that uses buckets to group elements with the same priority.
     The individual buckets are unsorted, which increases efficiency if these groups are large.
     The elements are assumed to be integer coordinates, and the priorities are assumed
-    to be squared euclidean distances (integers).
+    to be squared euclidean distances (integers) between two cells of the map.
+
+    There is one bucket per squared distance within the map, in increasing order. A bucket is a first-in first-out
+    chain of blocks of elements, drawn from one pool and returned to it once read, so a bucket is read and written
+    sequentially. A bitmap of the non-empty buckets finds the next bucket 64 buckets at a time.
+    The memory is kept between updates of maps of the same size.
 */
 class BucketPrioQueue {
 
  public:
-  //! Standard constructor
-  /** Standard constructor. When called for the first time it creates a look up table
-      that maps square distanes to bucket numbers, which might take some time...
-  */
+  //! Standard constructor, the queue has to be sized before the first push
   BucketPrioQueue();
+  //! Sizes the queue for the squared distances between the cells of a map, emptying it
+  void resize(int sizeX, int sizeY);
   //! Checks whether the Queue is empty
-  bool empty();
+  bool empty() { return count==0; }
   //! push an element
   void push(int prio, INTPOINT t);
   //! return and pop the element with the lowest squared distance */
   INTPOINT pop();
 
  private:
+  //! The number of elements of a block
+  enum { blockSize = 64 };
+  //! A block of elements of a bucket
+  struct Block {
+    INTPOINT points[blockSize];
+    //! the next block of the bucket or of the free blocks, -1 at the end
+    int next;
+  };
+  //! The blocks of a bucket, -1 if it is empty
+  struct Bucket {
+    //! the block read from
+    int head;
+    //! the block written to
+    int tail;
+    //! the next element read in the head block
+    int headPos;
+    //! the next element written in the tail block
+    int tailPos;
+  };
+
+  //! returns a free block, growing the pool if there is none
+  int allocateBlock();
+  //! returns a block to the free blocks
+  void freeBlock(int block) { blocks[block].next = freeBlocks; freeBlocks = block; }
 
-  static void initSqrIndices();
-  static std::vector<int> sqrIndices;
-  static int numBuckets;
+  //! the bucket of every squared distance, -1 if it is not a sum of two squares
+  std::vector<int> sqrIndices;
+  //! the buckets in increasing order of their squared distances
+  std::vector<Bucket> buckets;
+  //! one bit per bucket, set if it is not empty
+  std::vector<uint64_t> nonEmpty;
+  //! the blocks of all buckets and the free ones
+  std::vector<Block> blocks;
+  //! the first free block, -1 if the pool has to grow
+  int freeBlocks;
+
+  int sizeX;
+  int sizeY;
   int count;
   int nextBucket;
-
-  std::vector<std::queue<INTPOINT> > buckets;
 };
 }
 #endif
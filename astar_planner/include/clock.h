@@ -0,0 +1,28 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+namespace HybridAStar {
+/*!
+   \brief The clock the planner measures its deadlines with, in seconds.
+
+   It defaults to a monotonic steady clock, so the core of the planner does not depend on ROS.
+   A different source, e.g. the ROS time of the node, can be injected through setSource.
+*/
+class Clock {
+ public:
+  /// A function returning the current time in seconds
+  typedef double (*Source)();
+
+  /// returns the current time in seconds of the current source
+  static double now() { return source(); }
+  /// replaces the source of the clock, nullptr restores the steady clock
+  static void setSource(Source source) { Clock::source = source ? source : steady; }
+  /// returns the time in seconds of the monotonic steady clock
+  static double steady();
+
+ private:
+  /// the current source of the clock
+  static Source source;
+};
+}
+#endif // CLOCK_H
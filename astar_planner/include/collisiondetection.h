@@ -1,12 +1,20 @@
 #ifndef COLLISIONDETECTION_H
 #define COLLISIONDETECTION_H
 
-#include <nav_msgs/OccupancyGrid.h>
+#include <cstdint>
+#include <iostream>
+#include <vector>
 
+#include "binarygrid.h"
 #include "constants.h"
+#include "dynamicvoronoi.h"
+#include "headinglayers.h"
 #include "lookup.h"
 #include "node2d.h"
 #include "node3d.h"
+#include "parameters.h"
+#include "stats.h"
+#include "sweptvolume.h"
 //#include <geometry_msgs/Vector3.h>
 
 #include "opencv2/opencv.hpp"
@@ -46,6 +54,7 @@ class CollisionDetection {
        standard: collision checking using the spatial occupancy enumeration
        other: collision checking using the 2d costmap and the navigation stack
     */
+    STATS_COUNT(collisionChecks);
     float cost = 0;
     float x;
     float y;
@@ -57,11 +66,10 @@ class CollisionDetection {
     if (t == 99) {
       int idx = node->getIdx();
       //std::cout<<"starts here1"<<std::endl;
-      int Y = idx / gridmap_.size().width;
-      int X = idx - Y*gridmap_.size().width;
+      int Y = idx / grid_.getSizeY();
+      int X = idx - Y*grid_.getSizeY();
       //std::cout<<"isTraversable t==99"<<std::endl;
-      if((int)gridmap_.at<cv::Vec3b>(X,Y).val[0]==255) std::cout<<"not traversable! t=99"<<std::endl;
-      return !((int)gridmap_.at<cv::Vec3b>(X,Y).val[0]==255);
+      return !grid_.isOccupied(X, Y);
     }
 
     if (true) {
@@ -77,6 +85,14 @@ class CollisionDetection {
     return cost <= 0;
   }
 
+  /*!
+     \brief Evaluates whether the vehicle stays safe between a node and its successor, the nodes themselves are not tested
+     \param pred the predecessor
+     \param i the motion primitive leading to the successor
+     \return true if the swept cells are free, else false
+  */
+  bool isTraversable(const Node3D* pred, int i) const;
+
   /*!
      \brief Calculates the cost of the robot taking a specific configuration q int the World W
      \param x the x position
@@ -96,14 +112,116 @@ class CollisionDetection {
   */
   bool configurationTest(float x, float y, float t);
 
-  void updateGrid(cv::Mat &gridmap) {gridmap_ = gridmap;}
+  /*!
+     \brief Tests a batch of configurations, consecutive configurations of the same cell, position and heading of the lookup share their test
+     \param nodes the configurations
+     \param n the number of configurations
+     \param traversable set to 1 for every configuration in C_free, else 0
+     \return the number of configurations in C_free
+  */
+  int traversableMask(const Node3D* nodes, int n, uint8_t* traversable);
+
+  /*!
+     \brief Evaluates whether all configurations of a batch are safe, e.g. the samples of a path, stopping at the first collision
+     \param nodes the configurations
+     \param n the number of configurations
+     \return true if all of them are traversable, else false
+  */
+  bool areTraversable(const Node3D* nodes, int n);
+
+  /// converts the occupancy image into the bit-packed grid the tests read, dilating it per heading if the layers are enabled
+  void updateGrid(const cv::Mat& gridmap) {
+    grid_.update(gridmap);
+
+    if (Constants::headingLayers) { layers_.update(grid_); }
+  }
+
+  /// returns the bit-packed grid of the current map
+  const BinaryGrid& getGrid() const {return grid_;}
+
+  /*!
+     \brief Sets the distance map the circle test reads, it has to describe the current grid
+     \param voronoi the Voronoi diagram of the current grid, nullptr restricts the test to the footprint
+  */
+  void updateDistanceMap(DynamicVoronoi* voronoi) {voronoi_ = voronoi;}
 
  private:
+  /// The configuration of the collision lookup a pose falls into
+  struct Key {
+    /// the row of the cell
+    int X;
+    /// the column of the cell
+    int Y;
+    /// the index of the position within the cell and the heading in the lookup
+    int idx;
+    bool operator==(const Key& rhs) const { return X == rhs.X && Y == rhs.Y && idx == rhs.idx; }
+  };
+  /// returns the configuration of the lookup of the pose
+  Key key(float x, float y, float t) const {
+    int iX = (int)((x - (long)x) * Constants::positionResolution);
+    iX = iX > 0 ? iX : 0;
+    int iY = (int)((y - (long)y) * Constants::positionResolution);
+    iY = iY > 0 ? iY : 0;
+    int iT = (int)(t / Parameters::deltaHeading());
+    Key k = {(int)x, (int)y, (iY * Constants::positionResolution + iX) * headings + iT};
+    return k;
+  }
+  /// tests the configuration of the lookup
+  bool configurationTest(const Key& key);
+  /// The configurations of the current batch
+  std::vector<Key> keys;
+
   /// The occupancy grid
   //nav_msgs::OccupancyGrid::Ptr grid;
-  cv::Mat gridmap_;
-  /// The collision lookup table
-  Constants::config collisionLookup[Constants::headings * Constants::positions];
+  BinaryGrid grid_;
+  /// The collision lookup table, shared by all configuration spaces
+  const Constants::config* collisionLookup;
+  /// The number of headings of the lookup
+  int headings;
+
+  /// The configuration space obstacles of the grid per heading
+  HeadingLayers layers_;
+  /// The cells swept between the nodes by every primitive, shared by all configuration spaces
+  const SweptVolume* sweptVolume;
+
+  /// The cells of a configuration of the lookup as a bit mask per row of its bounding box
+  struct Footprint {
+    /// the row of the bounding box relative to the center
+    int x;
+    /// the column of the bounding box relative to the center
+    int y;
+    /// the number of rows of the bounding box
+    int rows;
+    /// the index of the mask of the first row
+    int offset;
+  };
+  /// The footprints of the lookup, a footprint wider than a word has no masks and is tested cell by cell
+  std::vector<Footprint> footprints;
+  /// The masks of the rows of the footprints, the cell in the column of the bounding box in the lowest bit
+  std::vector<uint64_t> footprintMasks;
+
+  /// The outcome of the circle test
+  enum CircleTest {circlesFree, circlesBlocked, circlesUnknown};
+  /*!
+     \brief Tests the configuration with the circles covering the footprint of the lookup on the distance map
+     \return circlesUnknown if an obstacle is near the boundary of the footprint and the footprint has to be tested
+  */
+  CircleTest circleTest(int X, int Y, int idx) const;
+  /// The distance map of the current grid
+  DynamicVoronoi* voronoi_ = nullptr;
+  /// The cells of the center of the footprint and of the centers of the circles, relative to the cell of the configuration
+  struct Circles {
+    /// the rows of the cells, the center of the footprint first
+    int8_t x[Constants::circles + 1];
+    /// the columns of the cells, the center of the footprint first
+    int8_t y[Constants::circles + 1];
+  };
+  /// The circles of every configuration of the lookup
+  std::vector<Circles> circles;
+  /// [cells] The radius of the circles covering the vehicle, including the margin of the discretization
+  float circleRadius;
+  /// [cells] The radius of the inscribed circle of the vehicle, excluding the margin of the discretization
+  float innerRadius;
 };
 }
 #endif // COLLISIONDETECTION_H
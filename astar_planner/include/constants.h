@@ -43,20 +43,65 @@ static const bool reverse = false;
 static const bool dubinsShot = true;
 /// A flag to toggle the Dubin's heuristic, this should be false, if reversing is enabled (true = on; false = off)
 static const bool dubins = true;
-/*!
-   \var static const bool dubinsLookup
-   \brief A flag to toggle the Dubin's heuristic via lookup, potentially speeding up the search by a lot
-   \todo not yet functional
-*/
-static const bool dubinsLookup = false * dubins;
+/// A flag to toggle the Dubin's heuristic via lookup, potentially speeding up the search by a lot
+static const bool dubinsLookup = true && dubins;
 /// A flag to toggle the 2D heuristic (true = on; false = off)
 static const bool twoD = false;
+/// A flag to compute the 2D heuristic as one cost-to-goal field per plan instead of a 2D A* per cell, turning it into a lookup
+static const bool twoDField = true && twoD;
+/// A flag to toggle the anytime search, restarting weighted searches with decreasing inflation until the deadline (true = on; false = off)
+static const bool anytime = true;
+/// A flag to toggle the incremental replanning, repairing the path of the previous map instead of planning from scratch (true = on; false = off)
+static const bool incremental = true;
+/// A flag to select the open list (true = indexed 4-ary heap with decrease-key; false = boost binomial heap with lazy deletion)
+static const bool indexedHeap = true;
+/// A flag to check collisions with circles covering the vehicle on the distance map, falling back to the footprint only near obstacles (true = on; false = off),
+/// off as `planner_replay` on `map_generator/data/map2.avi` measures no gain with the exact distance map
+static const bool circleCollision = false;
+/// A flag to test the cells the vehicle sweeps between a node and its successor, so thin obstacles cannot be tunneled (true = on; false = off)
+static const bool sweptCollision = true;
+/// A flag to dilate the map by the footprint of every heading once per map, turning the collision test into a bit lookup at the cost of the resolution of the position (true = on; false = off)
+static const bool headingLayers = false;
+/// The ways the distance map of the collision test and the smoother follows the map
+enum class VoronoiMode {
+  /// rebuilds the distance map and the Voronoi diagram with the brushfire on every map
+  brushfire,
+  /// rebuilds the distance map and the Voronoi diagram with an exact distance transform split over the cores on every map
+  exact,
+  /// updates the distance map and the Voronoi diagram with the cells that changed since the previous map, rebuilding them like exact beyond voronoiChangeShare
+  incremental,
+  /// computes the distance of a cell when the search or the smoother first queries it, without a Voronoi diagram, the cells never queried keep an infinite distance
+  lazy
+};
+/// The way the distance map follows the map, see VoronoiMode. Without the circle test incremental and lazy plan the frames of
+/// `map_generator/data/map2.avi` at the same latency of map update and plan together and exact is the slowest, incremental keeps the Voronoi diagram for the smoother
+static const VoronoiMode voronoiMode = VoronoiMode::incremental;
 
 // _________________
 // GENERAL CONSTANTS
 
 /// [#] --- Limits the maximum search depth of the algorithm, possibly terminating without the solution
 static const int iterations = 40000;
+/// [s] --- The default wall clock budget of a plan, after which the search returns the best path found so far
+static const double deadline = 0.5;
+/// [#] --- The number of iterations of the hybrid A* between two readings of the clock, a power of two
+static const int clockInterval = 64;
+/// [#] --- The inflation of the heuristic in the first anytime search, trading optimality for a quick first path
+static const float inflation = 2.5;
+/// [#] --- The decrement of the inflation between two anytime searches, the last search runs without inflation
+static const float inflationStep = 0.5;
+/// [#] --- The maximum distance in cells between the start and the previous path for the path to be reused
+static const float replanTolerance = 2;
+/// [#] --- The share of the cells of a map that may change for the Voronoi diagram to be updated incrementally, beyond it a rebuild is faster.
+/// Only VoronoiMode::incremental reads it. Measured with
+/// `planner_replay --voronoi incremental --change-share` on `map_generator/data/map2.avi`: larger shares raise the p99 of the map update
+static const float voronoiChangeShare = 0.002;
+/// [#] --- The distance in cells behind a blocked part of the previous path after which the repair rejoins it, about the turning radius of the motion primitives
+static const float replanMargin = 30;
+/// [#] --- The number of maps per debug snapshot of the Voronoi diagram and the path, 0 turns the snapshots off
+static const int debugSampling = 10;
+/// [#] --- The number of debug snapshots that may wait for the disk, further snapshots are dropped
+static const int debugQueue = 2;
 /// [m] --- Uniformly adds a padding around the vehicle
 static const double bloating = 0;
 /// [m] --- The width of the vehicle
@@ -65,20 +110,15 @@ static const double bloating = 0;
 // static const double length = 0.5 + 2 * bloating;
 
 // For DEBUG
+/// [m] --- The default width of the footprint, see Parameters
 static const double width = 0.3 + 2 * bloating;
-/// [m] --- The length of the vehicle
+/// [m] --- The default length of the footprint, see Parameters
 static const double length = 0.5 + 2 * bloating;
 
 /// [m] --- The minimum turning radius of the vehicle
 static const float r = 3;
-/// [m] --- The number of discretizations in heading
-static const int headings = 12; //headings^2 * dubinsWidth^2 has to be an integer
-/// [°] --- The discretization value of the heading (goal condition)
-static const float deltaHeadingDeg = 360 / (float)headings;
-/// [c*M_PI] --- The discretization value of heading (goal condition)
-static const float deltaHeadingRad = 2 * M_PI / (float)headings;
-/// [c*M_PI] --- The heading part of the goal condition
-static const float deltaHeadingNegRad = 2 * M_PI - deltaHeadingRad;
+/// [#] --- The default number of discretizations in heading, see Parameters
+static const int headings = 12;
 /// [m] --- The cell size of the 2D grid of the world
 static const float cellSize = 0.04;
 /*!
@@ -112,17 +152,22 @@ static const float dubinsStepSize = 0.03;
 // ______________________
 // DUBINS LOOKUP SPECIFIC
 
-/// [m] --- The width of the dubinsArea / 2 for the analytical solution (Dubin's shot)
-static const int dubinsWidth = 0.5;
-/// [m] --- The area of the lookup for the analytical solution (Dubin's shot)
-static const int dubinsArea = dubinsWidth * dubinsWidth;
+/// [#] --- The half width of the square around the goal covered by the lookup in cells
+static const int dubinsWidth = 64;
+/// [#] --- The number of discrete relative headings of the lookup
+static const int dubinsHeadings = 72;
+/// [#] --- The number of cells of the lookup, only the half with positive y is stored as the other one is its mirror image
+static const int dubinsArea = (2 * dubinsWidth + 1) * (dubinsWidth + 1);
+/// [#] --- The number of entries of the lookup
+static const int dubinsSize = dubinsArea * dubinsHeadings;
 
 
 // _________________________
 // COLLISION LOOKUP SPECIFIC
 
-/// [m] -- The bounding box size length and width to precompute all possible headings
-static const int bbSize = std::ceil(sqrt(width * width + length* length) / cellSize);
+/// [#] --- The number of circles along the length of the vehicle covering its footprint for the distance map test
+static const int circles = 3;
+
 /// [#] --- The sqrt of the number of discrete positions per cell
 static const int positionResolution = 10;
 /// [#] --- The number of discrete positions per cell
@@ -138,12 +183,8 @@ struct relPos {
 struct config {
   /// the number of cells occupied by this configuration of the vehicle
   int length;
-  /*!
-     \var relPos pos[64]
-     \brief The maximum number of occupied cells
-     \todo needs to be dynamic
-  */
-  relPos pos[128];
+  /// the occupied cells, stored by the lookup
+  const relPos* pos;
 };
 
 // _________________
@@ -0,0 +1,97 @@
+#ifndef DEBUGWRITER_H
+#define DEBUGWRITER_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dynamicvoronoi.h"
+#include "node3d.h"
+
+namespace HybridAStar {
+/*!
+   \brief Writes snapshots of the distance map, the Voronoi diagram and the path to disk on a background thread.
+
+   The planner only copies the cells and the path of a sampled map into a recycled snapshot and queues it,
+   the image is rendered and written by the thread of the writer, so diagnostics never block the planner.
+   If the queue is full the snapshot is dropped instead of waiting for the disk.
+   The image is the ppm of DynamicVoronoi::visualize with the path drawn on top, on a lazy map the cells never queried are white,
+   it is written to a temporary file first and renamed, so a viewer never reads a partial image.
+*/
+class DebugWriter {
+ public:
+  /*!
+     \brief Starts the thread of the writer
+
+     \param file the ppm file every snapshot overwrites
+     \param sampling the number of maps per snapshot, 0 turns the writer off
+     \param capacity the number of snapshots that may wait for the disk
+  */
+  DebugWriter(const std::string& file, int sampling = Constants::debugSampling, int capacity = Constants::debugQueue);
+  /// writes the queued snapshots and stops the thread
+  ~DebugWriter();
+
+  /*!
+     \brief Queues a snapshot of the diagram and the path if the map is sampled and the queue has room
+
+     \param voronoi the diagram of the current map
+     \param path the path planned on it
+     \return whether a snapshot has been queued
+  */
+  bool write(DynamicVoronoi& voronoi, const std::vector<Node3D>& path);
+
+  /// returns the number of sampled maps dropped because the queue was full
+  int getDropped() const { return dropped; }
+
+ private:
+  /// A copy of everything the image shows, taken on the thread of the planner
+  struct Snapshot {
+    /// the horizontal size of the map
+    int sizeX = 0;
+    /// the vertical size of the map
+    int sizeY = 0;
+    /// the obstacle distance of every cell, row after row
+    std::vector<float> dist;
+    /// the state of every cell, row after row
+    std::vector<char> state;
+    /// the cells of the path
+    std::vector<INTPOINT> path;
+  };
+
+  /// The state of a cell of a snapshot
+  enum { freeCell, voronoiCell, obstacleCell };
+
+  /// writes the queued snapshots until the writer is destroyed
+  void run();
+  /// renders a snapshot and writes it to the file
+  void save(const Snapshot& snapshot) const;
+
+  /// the ppm file every snapshot overwrites
+  std::string file;
+  /// the number of maps per snapshot
+  int sampling;
+  /// the number of snapshots that may wait for the disk
+  int capacity;
+  /// the number of maps seen by write
+  int maps = 0;
+  /// the number of sampled maps dropped because the queue was full
+  int dropped = 0;
+
+  /// guards the queue, the spare snapshots and the stop flag
+  std::mutex mutex;
+  /// wakes the thread of the writer
+  std::condition_variable wake;
+  /// the snapshots waiting for the disk
+  std::deque<Snapshot> queue;
+  /// the written snapshots, recycled so their arrays are only allocated once
+  std::vector<Snapshot> spare;
+  /// set when the writer is destroyed
+  bool stop = false;
+  /// the thread of the writer, started last
+  std::thread thread;
+};
+}
+#endif // DEBUGWRITER_H
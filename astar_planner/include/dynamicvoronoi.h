@@ -6,8 +6,11 @@
 #include <stdio.h>
 #include <limits.h>
 #include <queue>
+#include <vector>
 
+#include "binarygrid.h"
 #include "bucketedqueue.h"
+#include "threadpool.h"
 
 namespace HybridAStar {
 //! A DynamicVoronoi object computes and updates a distance map and Voronoi diagram.
@@ -16,12 +19,15 @@ class DynamicVoronoi {
  public:
 
   DynamicVoronoi();
-  ~DynamicVoronoi();
 
-  //! Initialization with an empty map
-  void initializeEmpty(int _sizeX, int _sizeY, bool initGridMap = true);
-  //! Initialization with a given binary map (false==free, true==occupied)
-  void initializeMap(int _sizeX, int _sizeY, bool** _gridMap);
+  //! Initialization with an empty map, a map with invalidObstData or more cells per side is refused, leaving an empty diagram and returning false
+  bool initializeEmpty(int _sizeX, int _sizeY, bool initGridMap = true);
+  //! Initialization with a given binary map (false==free, true==occupied), the map is copied and stays with the caller
+  bool initializeMap(int _sizeX, int _sizeY, bool** _gridMap);
+  //! Initialization with a bit-packed map, the cell (x,y) of the diagram is the cell (x,y) of the grid
+  bool initializeMap(const BinaryGrid& grid);
+  //! Initialization with a bit-packed map for distances computed on demand by getCell, without a Voronoi diagram
+  bool initializeLazy(const BinaryGrid& grid, ThreadPool& pool);
 
   //! add an obstacle at the specified cell coordinate
   void occupyCell(int x, int y);
@@ -32,6 +38,8 @@ class DynamicVoronoi {
 
   //! update distance map and Voronoi diagram to reflect the changes
   void update(bool updateRealDist = true);
+  //! rebuild distance map and Voronoi diagram from the binary map with an exact distance transform, split over the threads of the pool
+  void updateExact(ThreadPool& pool);
   //! prune the Voronoi diagram
   void prune();
 
@@ -51,14 +59,16 @@ class DynamicVoronoi {
 
   // was private, changed to public for obstX, obstY
  public:
+  //! A cell of the distance map, 16 bytes so four of them share a cache line
   struct dataCell {
     float dist;
+    int sqdist;
+    //! the coordinates of the closest obstacle, limiting the map to invalidObstData cells per side
+    short obstX;
+    short obstY;
     char voronoi;
     char queueing;
-    int obstX;
-    int obstY;
     bool needsRaise;
-    int sqdist;
   };
 
   typedef enum {voronoiKeep = -4, freeQueued = -3, voronoiRetry = -2, voronoiPrune = -1, free = 0, occupied = 1} State;
@@ -69,6 +79,20 @@ class DynamicVoronoi {
 
 
   // methods
+  //! returns the cell (x,y) of the distance map
+  dataCell& cell(int x, int y) { return data[x*sizeY + y]; }
+  //! returns the cell (x,y) of the distance map, computing and memoising its distance first if the map is lazy
+  const dataCell& getCell(int x, int y) {
+    dataCell& c = cell(x,y);
+    if (lazy && c.queueing==fwNotQueued) computeCell(x,y,c);
+    return c;
+  }
+  //! returns the cell (x,y) of the binary map
+  char& gridCell(int x, int y) { return gridMap[x*sizeY + y]; }
+
+  void initializeObstacles();
+  void updateRowDist(ThreadPool& pool);
+  void computeCell(int x, int y, dataCell& c);
   void setObstacle(int x, int y);
   void removeObstacle(int x, int y);
   inline void checkVoro(int x, int y, int nx, int ny, dataCell& c, dataCell& nc);
@@ -76,7 +100,7 @@ class DynamicVoronoi {
   void commitAndColorize(bool updateRealDist = true);
   inline void reviveVoroNeighbors(int& x, int& y);
 
-  inline bool isOccupied(int& x, int& y, dataCell& c);
+  inline bool isOccupied(int x, int y, const dataCell& c);
   inline markerMatchResult markerMatch(int x, int y);
 
   // queues
@@ -91,8 +115,14 @@ class DynamicVoronoi {
   // maps
   int sizeY;
   int sizeX;
-  dataCell** data;
-  bool** gridMap;
+  //! the distance map, row after row
+  std::vector<dataCell> data;
+  //! the binary map, row after row
+  std::vector<char> gridMap;
+  //! the distance of every cell to the closest obstacle in its row, used by updateExact and the lazy cells
+  std::vector<int> rowDist;
+  //! whether the distances are computed on demand, set by initializeLazy
+  bool lazy;
 
   // parameters
   int padding;
@@ -0,0 +1,66 @@
+#ifndef HEADINGLAYERS_H
+#define HEADINGLAYERS_H
+
+#include <cstdint>
+#include <vector>
+
+#include "binarygrid.h"
+#include "constants.h"
+
+namespace HybridAStar {
+/*!
+   \brief The configuration space obstacles of the current map, one bit layer per heading of the collision lookup.
+
+   Once per map the occupancy grid is dilated by the footprint of every heading, so testing a configuration is a single bit lookup.
+   The footprint of a heading is the union of the footprints of the lookup over all positions within a cell, which makes the layers
+   conservative by the resolution of the position: a configuration free in its layer is free in the footprint test as well.
+   Every footprint row is split into runs of columns, the rows of the grid are OR-ed over every run length once per map,
+   so a run costs a shifted OR of the words of a row regardless of its length.
+*/
+class HeadingLayers {
+ public:
+  /// builds the footprints of the headings from the shared collision lookup
+  HeadingLayers();
+
+  /// dilates the grid by the footprint of every heading
+  void update(const BinaryGrid& grid);
+
+  /// whether the cell lies on the map of the layers
+  bool contains(int x, int y) const { return x >= 0 && x < sizeX && y >= 0 && y < sizeY; }
+
+  /// returns whether the footprint of the heading iT placed in the cell (x,y) overlaps an obstacle, the cell has to lie on the map
+  bool isBlocked(int x, int y, int iT) const {
+    return (layers[(iT * sizeX + x) * stride + y / BinaryGrid::wordBits] >> (y % BinaryGrid::wordBits)) & 1;
+  }
+
+ private:
+  /// A run of columns in a row of a footprint, relative to the cell of the configuration
+  struct Run {
+    /// the row
+    int x;
+    /// the first column
+    int y;
+    /// the number of columns
+    int length;
+  };
+
+  /// The runs of the footprint of every heading
+  std::vector<std::vector<Run>> runs;
+  /// The longest run of all footprints
+  int maxLength = 0;
+  /// The number of empty words left of the spans, enough for the run starting furthest left
+  int padding = 1;
+
+  /// the number of rows of the map
+  int sizeX = 0;
+  /// the number of columns of the map
+  int sizeY = 0;
+  /// the number of words of a row
+  int stride = 0;
+  /// the rows of the grid OR-ed over every run length, the bit y of the length l holds the cells y to y+l-1, starting the padding left of the map
+  std::vector<uint64_t> spans;
+  /// the rows of the layers of every heading
+  std::vector<uint64_t> layers;
+};
+}
+#endif // HEADINGLAYERS_H
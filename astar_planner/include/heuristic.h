@@ -0,0 +1,43 @@
+#ifndef HEURISTIC_H
+#define HEURISTIC_H
+
+#include "constants.h"
+
+namespace HybridAStar {
+/*!
+    \brief The namespace that wraps the closed form non-holonomic heuristics
+    \namespace Heuristic
+
+    The lengths of the shortest Dubin's and Reeds-Shepp paths between two poses, ignoring obstacles.
+    The Dubin's length comes from the same solver as the Dubin's shot (dubins.h), the Reeds-Shepp length from a closed form kernel.
+    Both are evaluated on the stack without any allocation or virtual dispatch and match the distances of
+    `ompl::base::DubinsStateSpace` and `ompl::base::ReedsSheppStateSpace`.
+*/
+namespace Heuristic {
+
+/// The length of the shortest forward only path from (x0,y0,t0) to (x1,y1,t1) with the turning radius r
+float dubinsCost(float x0, float y0, float t0, float x1, float y1, float t1, float r = Constants::r);
+
+/// The length of the shortest forward and reverse path from (x0,y0,t0) to (x1,y1,t1) with the turning radius r
+float reedsSheppCost(float x0, float y0, float t0, float x1, float y1, float t1, float r = Constants::r);
+
+/*!
+   \brief Evaluates the Dubin's cost of n start poses to a single goal
+   \param x the x positions of the start poses
+   \param y the y positions of the start poses
+   \param t the headings of the start poses
+   \param cost the n costs to be written
+*/
+void dubinsCost(const float* x, const float* y, const float* t, int n, float x1, float y1, float t1, float* cost, float r = Constants::r);
+
+/*!
+   \brief Evaluates the Reeds-Shepp cost of n start poses to a single goal
+   \param x the x positions of the start poses
+   \param y the y positions of the start poses
+   \param t the headings of the start poses
+   \param cost the n costs to be written
+*/
+void reedsSheppCost(const float* x, const float* y, const float* t, int n, float x1, float y1, float t1, float* cost, float r = Constants::r);
+}
+}
+#endif // HEURISTIC_H
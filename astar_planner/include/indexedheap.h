@@ -0,0 +1,131 @@
+#ifndef INDEXEDHEAP_H
+#define INDEXEDHEAP_H
+
+#include <vector>
+
+namespace HybridAStar {
+/*!
+   \brief An indexed D-ary min heap of node pointers ordered by increasing total estimated cost C.
+
+   Every node is identified by its index in the node array (`getIdx()`), which also keys a position map into the heap.
+   Pushing a node whose index is already on the heap updates the existing entry (decrease-key) instead of adding a duplicate,
+   so the size of the heap is bounded by the number of open cells. The keys and indices are stored next to the pointers in one contiguous array,
+   so sifting never dereferences a node.
+*/
+template<typename T, int D = 4>
+class IndexedHeap {
+ public:
+  /// Constructor reserving the position map for node indices in [0, capacity)
+  explicit IndexedHeap(int capacity = 0) : position(capacity, -1) {}
+
+  /// determine whether the heap is empty
+  bool empty() const { return heap.empty(); }
+  /// get the number of nodes on the heap
+  size_t size() const { return heap.size(); }
+  /// get the node with the lowest C value
+  T* top() const { return heap.front().node; }
+
+  /// push a node or update its key if a node with the same index is already on the heap
+  void push(T* node) {
+    int idx = node->getIdx();
+
+    if (idx >= (int)position.size()) { position.resize(idx + 1, -1); }
+
+    int i = position[idx];
+
+    if (i < 0) {
+      heap.push_back(Entry(node->getC(), idx, node));
+      siftUp(heap.size() - 1);
+    } else {
+      float key = heap[i].key;
+      heap[i] = Entry(node->getC(), idx, node);
+
+      if (heap[i].key < key) { siftUp(i); }
+      else { siftDown(i); }
+    }
+  }
+
+  /// remove the node with the lowest C value
+  void pop() {
+    position[heap.front().idx] = -1;
+    Entry last = heap.back();
+    heap.pop_back();
+
+    if (!heap.empty()) {
+      heap.front() = last;
+      siftDown(0);
+    }
+  }
+
+  /// remove all nodes, only touching the position map entries that are in use, so the heap can be reused across searches
+  void clear() {
+    for (size_t i = 0; i < heap.size(); ++i) { position[heap[i].idx] = -1; }
+
+    heap.clear();
+  }
+
+ private:
+  /// An entry of the heap caching the key and the index of the node
+  struct Entry {
+    Entry(float key, int idx, T* node) : key(key), idx(idx), node(node) {}
+    /// the total estimated cost of the node when it was pushed
+    float key;
+    /// the index of the node
+    int idx;
+    /// the node
+    T* node;
+  };
+
+  /// move the entry at i up until its parent is not larger
+  void siftUp(size_t i) {
+    Entry e = heap[i];
+
+    while (i > 0) {
+      size_t parent = (i - 1) / D;
+
+      if (!(e.key < heap[parent].key)) { break; }
+
+      heap[i] = heap[parent];
+      position[heap[i].idx] = i;
+      i = parent;
+    }
+
+    heap[i] = e;
+    position[e.idx] = i;
+  }
+
+  /// move the entry at i down until none of its children is smaller
+  void siftDown(size_t i) {
+    Entry e = heap[i];
+    size_t n = heap.size();
+
+    while (true) {
+      size_t first = D * i + 1;
+
+      if (first >= n) { break; }
+
+      size_t last = first + D < n ? first + D : n;
+      size_t min = first;
+
+      for (size_t c = first + 1; c < last; ++c) {
+        if (heap[c].key < heap[min].key) { min = c; }
+      }
+
+      if (!(heap[min].key < e.key)) { break; }
+
+      heap[i] = heap[min];
+      position[heap[i].idx] = i;
+      i = min;
+    }
+
+    heap[i] = e;
+    position[e.idx] = i;
+  }
+
+  /// the heap entries in D-ary layout
+  std::vector<Entry> heap;
+  /// the position of each node index in the heap, -1 if it is not on the heap
+  std::vector<int> position;
+};
+}
+#endif // INDEXEDHEAP_H
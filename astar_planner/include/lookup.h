@@ -1,8 +1,14 @@
 #ifndef COLLISIONLOOKUP
 #define COLLISIONLOOKUP
 
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
 #include "dubins.h"
 #include "constants.h"
+#include "parameters.h"
 
 namespace HybridAStar {
 namespace Lookup {
@@ -10,52 +16,55 @@ namespace Lookup {
 //###################################################
 //                                      DUBINS LOOKUP
 //###################################################
+/*
+   The lookup is expressed in the frame of the goal, which is placed at the origin with a heading of zero.
+   A start pose then reduces to its relative position (X,Y) and relative heading, and mirroring it on the x axis
+   (Y -> -Y, heading -> -heading) swaps left and right turns without changing the length of the path.
+   Hence only the half Y >= 0 is stored, indexed by X in [-dubinsWidth, dubinsWidth], Y in [0, dubinsWidth]
+   and the relative heading in dubinsHeadings steps.
+*/
+
+/// [#] --- The version of the binary file format of the Dubin's lookup
+static const int dubinsFileVersion = 1;
+
+// ____________________
+// DUBINS LOOKUP INDEX
+inline int dubinsIndex(int X, int Y, int h) {
+  return ((X + Constants::dubinsWidth) * (Constants::dubinsWidth + 1) + Y) * Constants::dubinsHeadings + h;
+}
+
+// ______________________
+// DUBINS LOOKUP CREATION
 inline void dubinsLookup(float* lookup) {
-  bool DEBUG = false;
   std::cout << "I am building the Dubin's lookup table...";
 
   DubinsPath path;
 
-  int width = Constants::dubinsWidth / Constants::cellSize;
-
-  //  // increase the width by one to make it square
-  //  if (width % 2 != 0) {
-  //    width++;
-  //  }
-
-  const int headings = Constants::headings;
+  const int width = Constants::dubinsWidth;
+  const int headings = Constants::dubinsHeadings;
+  const double deltaHeading = 2 * M_PI / headings;
 
   // start and goal vector
   double start[3];
   double goal[] = {0, 0, 0};
 
   // iterate over the X index of a grid cell
-  for (int X = 0; X < width; ++X) {
+  for (int X = -width; X <= width; ++X) {
     start[0] = X;
 
     // iterate over the Y index of a grid cell
-    for (int Y = 0; Y < width; ++Y) {
+    for (int Y = 0; Y <= width; ++Y) {
       start[1] = Y;
 
-      // iterate over the start headings
-      for (int h0 = 0; h0 < headings; ++h0) {
-        start[2] = Constants::deltaHeadingRad * h0;
-
-        // iterate over the goal headings
-        for (int h1 = 0; h1 < headings; ++h1) {
-          goal[2] = Constants::deltaHeadingRad * h1;
-
-          // calculate the actual cost
-          dubins_init(start, goal, Constants::r, &path);
-          lookup[X * headings * headings * width + Y * headings * headings + h0 * headings + h1] = dubins_path_length(&path);
+      // iterate over the relative start headings
+      for (int h = 0; h < headings; ++h) {
+        start[2] = deltaHeading * h;
 
-          if (DEBUG && lookup[X * headings * headings * width + Y * headings * headings + h0 * headings + h1] < sqrt(X * X + Y * Y) * 1.000001) {
-            std::cout << X << " | " << Y << " | "
-                      << Constants::deltaHeadingDeg* h0 << " | "
-                      << Constants::deltaHeadingDeg* h1 << " length: "
-                      << lookup[X * headings * headings * width + Y * headings * headings + h0 * headings + h1] << "\n";
-
-          }
+        // calculate the actual cost
+        if (dubins_init(start, goal, Constants::r, &path) == EDUBOK) {
+          lookup[dubinsIndex(X, Y, h)] = dubins_path_length(&path);
+        } else {
+          lookup[dubinsIndex(X, Y, h)] = 0;
         }
       }
     }
@@ -64,6 +73,102 @@ inline void dubinsLookup(float* lookup) {
   std::cout << " done!" << std::endl;
 }
 
+// ____________________
+// DUBINS LOOKUP QUERY
+/*!
+   \brief Looks up the length of the Dubin's path from (x0,y0,t0) to (x1,y1,t1)
+   \param cost set to the length of the path if the start is within the lookup around the goal
+   \return true if the start is within the lookup, else false
+*/
+inline bool dubinsCost(const float* lookup, float x0, float y0, float t0, float x1, float y1, float t1, float& cost) {
+  // the position of the start in the frame of the goal
+  float cosT = std::cos(t1);
+  float sinT = std::sin(t1);
+  float dx = x0 - x1;
+  float dy = y0 - y1;
+  float x = cosT * dx + sinT * dy;
+  float y = -sinT * dx + cosT * dy;
+  float t = t0 - t1;
+
+  // mirror on the x axis
+  if (y < 0) {
+    y = -y;
+    t = -t;
+  }
+
+  int X = (int)std::floor(x + 0.5f);
+  int Y = (int)(y + 0.5f);
+
+  if (X < -Constants::dubinsWidth || X > Constants::dubinsWidth || Y > Constants::dubinsWidth) {
+    return false;
+  }
+
+  int h = (int)std::floor(t / (2 * M_PI) * Constants::dubinsHeadings + 0.5f) % Constants::dubinsHeadings;
+
+  if (h < 0) { h += Constants::dubinsHeadings; }
+
+  cost = lookup[dubinsIndex(X, Y, h)];
+  return true;
+}
+
+// ________________________
+// DUBINS LOOKUP PERSISTENCE
+/// The header of the binary file of the Dubin's lookup, the table is only valid for identical parameters
+struct dubinsHeader {
+  /// the version of the file format
+  int version;
+  /// the turning radius
+  float r;
+  /// the half width of the lookup
+  int width;
+  /// the number of relative headings
+  int headings;
+};
+
+/// The header describing the lookup of the current constants
+inline dubinsHeader currentDubinsHeader() {
+  dubinsHeader header = {dubinsFileVersion, Constants::r, Constants::dubinsWidth, Constants::dubinsHeadings};
+  return header;
+}
+
+/*!
+   \brief Loads the Dubin's lookup from a binary file
+   \return true if the file exists and matches the current constants, else false
+*/
+inline bool loadDubinsLookup(const char* filename, float* lookup) {
+  FILE* F = fopen(filename, "rb");
+
+  if (!F) { return false; }
+
+  dubinsHeader header;
+  dubinsHeader current = currentDubinsHeader();
+  bool valid = fread(&header, sizeof(header), 1, F) == 1 &&
+               header.version == current.version && header.r == current.r &&
+               header.width == current.width && header.headings == current.headings &&
+               fread(lookup, sizeof(float), Constants::dubinsSize, F) == (size_t)Constants::dubinsSize;
+  fclose(F);
+
+  if (valid) { std::cout << "I have loaded the Dubin's lookup table from " << filename << std::endl; }
+
+  return valid;
+}
+
+/// Saves the Dubin's lookup to a binary file, returns true on success
+inline bool saveDubinsLookup(const char* filename, const float* lookup) {
+  FILE* F = fopen(filename, "wb");
+
+  if (!F) {
+    std::cerr << "could not open " << filename << " for writing the Dubin's lookup!\n";
+    return false;
+  }
+
+  dubinsHeader header = currentDubinsHeader();
+  bool written = fwrite(&header, sizeof(header), 1, F) == 1 &&
+                 fwrite(lookup, sizeof(float), Constants::dubinsSize, F) == (size_t)Constants::dubinsSize;
+  fclose(F);
+  return written;
+}
+
 //###################################################
 //                                   COLLISION LOOKUP
 //###################################################
@@ -77,13 +182,16 @@ inline int sign(double x) {
 
 // _________________________
 // COLLISION LOOKUP CREATION
-inline void collisionLookup(Constants::config* lookup) {
+inline void collisionLookup(std::vector<Constants::config>& lookup, std::vector<Constants::relPos>& cells) {
   bool DEBUG = false;
   std::cout << "I am building the collision lookup table...";
+  const Parameters& parameters = Parameters::get();
   // cell size
   const float cSize = Constants::cellSize;
   // bounding box size length/width
-  const int size = Constants::bbSize;
+  const int size = parameters.bbSize();
+  // number of headings
+  const int headings = parameters.headings;
 
   struct point {
     double x;
@@ -121,7 +229,7 @@ inline void collisionLookup(Constants::config* lookup) {
   int stepX;
   int stepY;
   // grid
-  bool cSpace[size * size];
+  std::vector<char> cSpace(size * size);
   bool inside = false;
   int hcross1 = 0;
   int hcross2 = 0;
@@ -132,6 +240,10 @@ inline void collisionLookup(Constants::config* lookup) {
   const int positionResolution = Constants::positionResolution;
   const int positions = Constants::positions;
   point points[positions];
+  // the first cell of every configuration
+  std::vector<int> offsets(headings * positions);
+  lookup.assign(headings * positions, Constants::config());
+  cells.clear();
 
   // generate all discrete positions within one cell
   for (int i = 0; i < positionResolution; ++i) {
@@ -150,19 +262,19 @@ inline void collisionLookup(Constants::config* lookup) {
     c.x = (double)size / 2 + points[q].x;
     c.y = (double)size / 2 + points[q].y;
 
-    p[0].x = c.x - Constants::length / 2 / cSize;
-    p[0].y = c.y - Constants::width / 2 / cSize;
+    p[0].x = c.x - parameters.length / 2 / cSize;
+    p[0].y = c.y - parameters.width / 2 / cSize;
 
-    p[1].x = c.x - Constants::length / 2 / cSize;
-    p[1].y = c.y + Constants::width / 2 / cSize;
+    p[1].x = c.x - parameters.length / 2 / cSize;
+    p[1].y = c.y + parameters.width / 2 / cSize;
 
-    p[2].x = c.x + Constants::length / 2 / cSize;
-    p[2].y = c.y + Constants::width / 2 / cSize;
+    p[2].x = c.x + parameters.length / 2 / cSize;
+    p[2].y = c.y + parameters.width / 2 / cSize;
 
-    p[3].x = c.x + Constants::length / 2 / cSize;
-    p[3].y = c.y - Constants::width / 2 / cSize;
+    p[3].x = c.x + parameters.length / 2 / cSize;
+    p[3].y = c.y - parameters.width / 2 / cSize;
 
-    for (int o = 0; o < Constants::headings; ++o) {
+    for (int o = 0; o < headings; ++o) {
       if (DEBUG) { std::cout << "\ndegrees: " << theta * 180.f / M_PI << std::endl; }
 
       // initialize cSpace
@@ -184,7 +296,7 @@ inline void collisionLookup(Constants::config* lookup) {
       }
 
       // create the next angle
-      theta += Constants::deltaHeadingRad;
+      theta += parameters.deltaHeadingRad();
 
       // cell traversal clockwise
       for (int k = 0; k < 4; ++k) {
@@ -288,20 +400,21 @@ inline void collisionLookup(Constants::config* lookup) {
 
       // GENERATE THE ACTUAL LOOKUP
       count = 0;
+      offsets[q * headings + o] = cells.size();
 
       for (int i = 0; i < size; ++i) {
         for (int j = 0; j < size; ++j) {
           if (cSpace[i * size + j]) {
             // compute the relative position of the car cells
-            lookup[q * Constants::headings + o].pos[count].x = j - (int)c.x;
-            lookup[q * Constants::headings + o].pos[count].y = i - (int)c.y;
+            Constants::relPos cell = {j - (int)c.x, i - (int)c.y};
+            cells.push_back(cell);
             // add one for the length of the current list
             count++;
           }
         }
       }
 
-      lookup[q * Constants::headings + o].length = count;
+      lookup[q * headings + o].length = count;
 
       if (DEBUG) {
         //DEBUG
@@ -318,18 +431,146 @@ inline void collisionLookup(Constants::config* lookup) {
         }
 
         //TESTING
-        std::cout << "\n\nthe center of " << q* Constants::headings + o << " is at " << c.x << " | " << c.y << std::endl;
+        std::cout << "\n\nthe center of " << q* headings + o << " is at " << c.x << " | " << c.y << std::endl;
 
-        for (int i = 0; i < lookup[q * Constants::headings + o].length; ++i) {
-          std::cout << "[" << i << "]\t" << lookup[q * Constants::headings + o].pos[i].x << " | " << lookup[q * Constants::headings + o].pos[i].y << std::endl;
+        for (int i = 0; i < lookup[q * headings + o].length; ++i) {
+          std::cout << "[" << i << "]\t" << cells[offsets[q * headings + o] + i].x << " | " << cells[offsets[q * headings + o] + i].y << std::endl;
         }
       }
     }
   }
 
+  // the cells are in place, point the configurations at them
+  for (size_t i = 0; i < lookup.size(); ++i) { lookup[i].pos = cells.data() + offsets[i]; }
+
   std::cout << " done!" << std::endl;
 }
 
+// ___________________________
+// COLLISION LOOKUP PERSISTENCE
+/// [#] --- The version of the binary file format of the collision lookup
+static const int collisionFileVersion = 2;
+
+/// The header of the binary file of the collision lookup, the table is only valid for an identical vehicle and discretization
+struct collisionHeader {
+  /// the version of the file format
+  int version;
+  /// the width of the vehicle
+  float width;
+  /// the length of the vehicle
+  float length;
+  /// the cell size of the grid
+  float cellSize;
+  /// the number of headings
+  int headings;
+  /// the number of discrete positions per cell and dimension
+  int positionResolution;
+  /// the size of the bounding box of the footprints
+  int bbSize;
+  /// the number of cells of all configurations
+  int cells;
+};
+
+/// The header describing the lookup of the current parameters
+inline collisionHeader currentCollisionHeader(int cells = 0) {
+  const Parameters& parameters = Parameters::get();
+  collisionHeader header = {collisionFileVersion, parameters.width, parameters.length, Constants::cellSize,
+                            parameters.headings, Constants::positionResolution, parameters.bbSize(), cells
+                           };
+  return header;
+}
+
+/*!
+   \brief Loads the collision lookup from a binary file
+   \return true if the file exists and matches the current parameters, else false
+*/
+inline bool loadCollisionLookup(const char* filename, std::vector<Constants::config>& lookup, std::vector<Constants::relPos>& cells) {
+  FILE* F = fopen(filename, "rb");
+
+  if (!F) { return false; }
+
+  collisionHeader header;
+  collisionHeader current = currentCollisionHeader();
+  bool valid = fread(&header, sizeof(header), 1, F) == 1 &&
+               header.version == current.version && header.width == current.width && header.length == current.length &&
+               header.cellSize == current.cellSize && header.headings == current.headings &&
+               header.positionResolution == current.positionResolution && header.bbSize == current.bbSize && header.cells >= 0;
+
+  if (valid) {
+    // the number of cells of every configuration followed by all cells
+    std::vector<int> lengths(current.headings * Constants::positions);
+    cells.resize(header.cells);
+    valid = fread(lengths.data(), sizeof(int), lengths.size(), F) == lengths.size() &&
+            fread(cells.data(), sizeof(Constants::relPos), cells.size(), F) == cells.size();
+    lookup.assign(lengths.size(), Constants::config());
+    int offset = 0;
+
+    for (size_t i = 0; valid && i < lookup.size(); ++i) {
+      valid = lengths[i] >= 0 && offset + lengths[i] <= header.cells;
+      lookup[i].length = lengths[i];
+      lookup[i].pos = cells.data() + offset;
+      offset += lengths[i];
+    }
+  }
+
+  fclose(F);
+
+  if (valid) { std::cout << "I have loaded the collision lookup table from " << filename << std::endl; }
+
+  return valid;
+}
+
+/// Saves the collision lookup to a binary file, returns true on success
+inline bool saveCollisionLookup(const char* filename, const std::vector<Constants::config>& lookup, const std::vector<Constants::relPos>& cells) {
+  FILE* F = fopen(filename, "wb");
+
+  if (!F) {
+    std::cerr << "could not open " << filename << " for writing the collision lookup!\n";
+    return false;
+  }
+
+  collisionHeader header = currentCollisionHeader(cells.size());
+  std::vector<int> lengths(lookup.size());
+
+  for (size_t i = 0; i < lookup.size(); ++i) { lengths[i] = lookup[i].length; }
+
+  bool written = fwrite(&header, sizeof(header), 1, F) == 1 &&
+                 fwrite(lengths.data(), sizeof(int), lengths.size(), F) == lengths.size() &&
+                 fwrite(cells.data(), sizeof(Constants::relPos), cells.size(), F) == cells.size();
+  fclose(F);
+  return written;
+}
+
+// _______________________
+// SHARED COLLISION LOOKUP
+/*!
+   \brief Returns the collision lookup shared by all its owners, it is created once per process
+
+   The first call creates the lookup for the parameters of the process and fixes them, loading it from the file if it matches them,
+   else building it and saving it to the file. The file of later calls is ignored, so a file has to be passed before
+   the first configuration space is constructed.
+   \param filename the binary file of the lookup, nullptr to only build it
+*/
+inline const Constants::config* sharedCollisionLookup(const char* filename = nullptr) {
+  struct table {
+    explicit table(const char* filename) {
+      Parameters::freeze();
+
+      if (!filename || !loadCollisionLookup(filename, lookup, cells)) {
+        collisionLookup(lookup, cells);
+
+        if (filename) { saveCollisionLookup(filename, lookup, cells); }
+      }
+    }
+
+    std::vector<Constants::config> lookup;
+    std::vector<Constants::relPos> cells;
+  };
+
+  static const table shared(filename);
+  return shared.lookup.data();
+}
+
 }
 }
 #endif // LOOKUP
@@ -1,6 +1,7 @@
 #ifndef NODE2D_H
 #define NODE2D_H
 
+#include <atomic>
 #include <cmath>
 
 #include "constants.h"
@@ -26,6 +27,8 @@ class Node2D {
     this->c = false;
     this->d = false;
     this->idx = -1;
+    this->stamp = searchGeneration;
+    this->dStamp = planGeneration;
   }
   // GETTER METHODS
   /// get the x position
@@ -40,12 +43,12 @@ class Node2D {
   float getC() const { return g + h; }
   /// get the index of the node in the 2D array
   int getIdx() const { return idx; }
-  /// determine whether the node is open
-  bool  isOpen() const { return o; }
-  /// determine whether the node is closed
-  bool  isClosed() const { return c; }
-  /// determine whether the node is discovered
-  bool  isDiscovered() const { return d; }
+  /// determine whether the node is open in the current search
+  bool  isOpen() const { return o && stamp == searchGeneration; }
+  /// determine whether the node is closed in the current search
+  bool  isClosed() const { return c && stamp == searchGeneration; }
+  /// determine whether the node is discovered in the current plan
+  bool  isDiscovered() const { return d && dStamp == planGeneration; }
   /// get a pointer to the predecessor
   Node2D* getPred() const { return pred; }
 
@@ -61,19 +64,23 @@ class Node2D {
   /// set and get the index of the node in the 2D array
   int setIdx(int width) { this->idx = y * width + x; return idx;}
   /// open the node
-  void open() { o = true; c = false; }
+  void open() { o = true; c = false; stamp = searchGeneration; }
   /// close the node
-  void close() { c = true; o = false; }
+  void close() { c = true; o = false; stamp = searchGeneration; }
   /// set the node neither open nor closed
   void reset() { c = false; o = false; }
   /// discover the node
-  void discover() { d = true; }
+  void discover() { d = true; dStamp = planGeneration; }
+  /// start a new search, leaving all existing nodes neither open nor closed in O(1)
+  static void nextSearch() { searchGeneration = ++generations; }
+  /// start a new plan, additionally leaving all existing nodes undiscovered in O(1)
+  static void nextPlan() { searchGeneration = ++generations; planGeneration = ++generations; }
   /// set a pointer to the predecessor of the node
   void setPred(Node2D* pred) { this->pred = pred; }
 
   // UPDATE METHODS
   /// Updates the cost-so-far for the node x' coming from its predecessor. It also discovers the node.
-  void updateG() { g += movementCost(*pred); d = true; }
+  void updateG() { g += movementCost(*pred); discover(); }
   /// Updates the cost-to-go for the node x' to the goal node.
   void updateH(const Node2D& goal) { h = movementCost(goal); }
   /// The heuristic as well as the cost measure.
@@ -88,8 +95,10 @@ class Node2D {
   bool isOnGrid(const int width, const int height) const;
 
   // SUCCESSOR CREATION
-  /// Creates a successor on a eight-connected grid.
-  Node2D* createSuccessor(const int i);
+  /// Creates a successor on a eight-connected grid, writing it into the caller owned node `succ` instead of the heap.
+  Node2D* createSuccessor(const int i, Node2D* succ);
+  /// Creates a successor on a eight-connected grid on the heap, the caller owns and deletes it.
+  Node2D* createSuccessor(const int i) { return createSuccessor(i, new Node2D); }
 
   // CONSTANT VALUES
   /// Number of possible directions
@@ -98,6 +107,12 @@ class Node2D {
   static const int dx[];
   /// Possible movements in the y direction
   static const int dy[];
+  /// The generation of the current search on this thread, nodes stamped with another one are neither open nor closed
+  static thread_local unsigned int searchGeneration;
+  /// The generation of the current plan on this thread, nodes stamped with another one are not discovered
+  static thread_local unsigned int planGeneration;
+  /// The last generation handed out, unique across threads so that searches on different threads never share one
+  static std::atomic<unsigned int> generations;
 
  private:
   /// the x position
@@ -116,6 +131,10 @@ class Node2D {
   bool c;
   /// the discovered value
   bool d;
+  /// the search generation the open and closed values belong to
+  unsigned int stamp;
+  /// the plan generation the discovered value belongs to
+  unsigned int dStamp;
   /// the predecessor pointer
   Node2D* pred;
 };
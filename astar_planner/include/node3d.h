@@ -1,9 +1,11 @@
 #ifndef NODE3D_H
 #define NODE3D_H
 
+#include <atomic>
 #include <cmath>
 
 #include "constants.h"
+#include "parameters.h"
 #include "helper.h"
 namespace HybridAStar {
 /*!
@@ -28,6 +30,7 @@ class Node3D {
     this->c = false;
     this->idx = -1;
     this->prim = prim;
+    this->stamp = generation;
   }
 
   // GETTER METHODS
@@ -47,10 +50,10 @@ class Node3D {
   int getIdx() const { return idx; }
   /// get the number associated with the motion primitive of the node
   int getPrim() const { return prim; }
-  /// determine whether the node is open
-  bool isOpen() const { return o; }
-  /// determine whether the node is closed
-  bool isClosed() const { return c; }
+  /// determine whether the node is open in the current search
+  bool isOpen() const { return o && stamp == generation; }
+  /// determine whether the node is closed in the current search
+  bool isClosed() const { return c && stamp == generation; }
   /// determine whether the node is open
   const Node3D* getPred() const { return pred; }
 
@@ -66,11 +69,13 @@ class Node3D {
   /// set the cost-to-come (heuristic value)
   void setH(const float& h) { this->h = h; }
   /// set and get the index of the node in the 3D grid
-  int setIdx(int width, int height) { this->idx = (int)(t / Constants::deltaHeadingRad) * width * height + (int)(y) * width + (int)(x); return idx;}
+  int setIdx(int width, int height) { this->idx = (int)(t / Parameters::deltaHeading()) * width * height + (int)(y) * width + (int)(x); return idx;}
   /// open the node
-  void open() { o = true; c = false;}
+  void open() { o = true; c = false; stamp = generation; }
   /// close the node
-  void close() { c = true; o = false; }
+  void close() { c = true; o = false; stamp = generation; }
+  /// start a new search, leaving all existing nodes neither open nor closed in O(1)
+  static void nextGeneration() { generation = ++generations; }
   /// set a pointer to the predecessor of the node
   void setPred(const Node3D* pred) { this->pred = pred; }
 
@@ -91,8 +96,10 @@ class Node3D {
   bool isOnGrid(const int width, const int height) const;
 
   // SUCCESSOR CREATION
-  /// Creates a successor in the continous space.
-  Node3D* createSuccessor(const int i);
+  /// Creates a successor in the continous space, writing it into the caller owned node `succ` instead of the heap.
+  Node3D* createSuccessor(const int i, Node3D* succ);
+  /// Creates a successor in the continous space on the heap, the caller owns and deletes it.
+  Node3D* createSuccessor(const int i) { return createSuccessor(i, new Node3D); }
 
   // CONSTANT VALUES
   /// Number of possible directions
@@ -103,6 +110,10 @@ class Node3D {
   static const float dy[];
   /// Possible movements regarding heading theta
   static const float dt[];
+  /// The generation of the current search on this thread, nodes stamped with another one are neither open nor closed
+  static thread_local unsigned int generation;
+  /// The last generation handed out, unique across threads so that searches on different threads never share one
+  static std::atomic<unsigned int> generations;
 
  private:
   /// the x position
@@ -123,6 +134,8 @@ class Node3D {
   bool c;
   /// the motion primitive of the node
   int prim;
+  /// the generation the open and closed values belong to
+  unsigned int stamp;
   /// the predecessor pointer
   const Node3D* pred;
 };
@@ -0,0 +1,67 @@
+#ifndef OPENLIST_H
+#define OPENLIST_H
+
+#include <type_traits>
+
+#include <boost/heap/binomial_heap.hpp>
+
+#include "constants.h"
+#include "indexedheap.h"
+#include "node2d.h"
+#include "node3d.h"
+
+namespace HybridAStar {
+//###################################################
+//                                    NODE COMPARISON
+//###################################################
+/*!
+   \brief A structure to sort nodes in a heap structure
+*/
+struct CompareNodes {
+  /// Sorting 3D nodes by increasing C value - the total estimated cost
+  bool operator()(const Node3D* lhs, const Node3D* rhs) const {
+    return lhs->getC() > rhs->getC();
+  }
+  /// Sorting 2D nodes by increasing C value - the total estimated cost
+  bool operator()(const Node2D* lhs, const Node2D* rhs) const {
+    return lhs->getC() > rhs->getC();
+  }
+};
+
+//###################################################
+//                                          OPEN LIST
+//###################################################
+/*!
+   \brief The boost binomial heap behind the interface of the IndexedHeap
+
+   Rewired nodes are pushed a second time and the stale entries are discarded lazily once they are popped.
+*/
+template<typename T>
+class BinomialHeap {
+ public:
+  /// Constructor, the capacity is only needed by the IndexedHeap
+  explicit BinomialHeap(int capacity = 0) {}
+  /// determine whether the heap is empty
+  bool empty() const { return O.empty(); }
+  /// get the number of entries on the heap
+  size_t size() const { return O.size(); }
+  /// get the node with the lowest C value
+  T* top() const { return O.top(); }
+  /// push a node
+  void push(T* node) { O.push(node); }
+  /// remove the node with the lowest C value
+  void pop() { O.pop(); }
+  /// remove all nodes
+  void clear() { O.clear(); }
+
+ private:
+  boost::heap::binomial_heap<T*, boost::heap::compare<CompareNodes>> O;
+};
+
+/// The open list used by both searches, selected at compile time via Constants::indexedHeap
+template<typename T>
+struct OpenList {
+  typedef typename std::conditional<Constants::indexedHeap, IndexedHeap<T>, BinomialHeap<T>>::type type;
+};
+}
+#endif // OPENLIST_H
@@ -0,0 +1,62 @@
+#ifndef PARAMETERS_H
+#define PARAMETERS_H
+
+#include <string>
+
+#include "constants.h"
+
+namespace HybridAStar {
+/*!
+   \brief The footprint of the vehicle and the heading resolution of the search, set at runtime.
+
+   They default to the constants and can be read from the system config, so the resolution can be tuned per course without recompiling.
+   Every lookup table, primitive table and node array of the planner is sized from the parameters of the process,
+   which are fixed once the first table has been built: setting them afterwards fails instead of leaving the tables mismatched.
+*/
+class Parameters {
+ public:
+  /// [m] --- The width of the footprint tested for collisions
+  float width = Constants::width;
+  /// [m] --- The length of the footprint tested for collisions
+  float length = Constants::length;
+  /// [#] --- The number of discretizations in heading, it has to divide 360
+  int headings = Constants::headings;
+
+  /// [c*M_PI] --- The discretization value of heading (goal condition)
+  float deltaHeadingRad() const { return 2 * M_PI / headings; }
+  /// [cells] --- The bounding box size length and width of the footprints, with a cell on either side for the discrete positions within the center cell
+  int bbSize() const { return std::ceil(std::sqrt(width * width + length * length) / Constants::cellSize) + 2; }
+
+  /*!
+     \brief Reads the parameters from the system config, keys missing from the file keep their values
+
+     The keys are `Path.footprint_width`, `Path.footprint_length` and `Path.headings`.
+     \return false if the file cannot be read
+  */
+  bool load(const std::string& file);
+  /// returns whether the parameters describe a footprint and a heading resolution the tables support, printing the reason if not
+  bool isValid() const;
+
+  /// returns the parameters of the process
+  static const Parameters& get() { return current; }
+  /*!
+     \brief Replaces the parameters of the process, which is only possible before the first table is built
+     \return false if the parameters are invalid or already in use
+  */
+  static bool set(const Parameters& parameters);
+  /// marks the parameters of the process as in use by a table, called by everything sized from them
+  static void freeze() { frozen = true; }
+
+  /// [c*M_PI] --- The discretization value of heading of the process, cached for the hot paths of the search
+  static float deltaHeading() { return currentDeltaHeading; }
+
+ private:
+  /// the parameters of the process
+  static Parameters current;
+  /// the heading discretization of the current parameters
+  static float currentDeltaHeading;
+  /// set once a table has been sized from the current parameters
+  static bool frozen;
+};
+}
+#endif // PARAMETERS_H
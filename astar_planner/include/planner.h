@@ -0,0 +1,121 @@
+#ifndef PLANNER_H
+#define PLANNER_H
+
+#include <string>
+#include <vector>
+
+#include "opencv2/opencv.hpp"
+
+#include "algorithm.h"
+#include "collisiondetection.h"
+#include "constants.h"
+#include "dynamicvoronoi.h"
+#include "node2d.h"
+#include "node3d.h"
+#include "replanner.h"
+#include "smoother.h"
+#include "threadpool.h"
+
+namespace HybridAStar {
+/*!
+   \brief The planning pipeline of a single occupancy map without any ROS dependency.
+
+   It owns everything a plan needs: the configuration space, the Voronoi diagram, the node arrays, the Dubin's lookup,
+   the incremental replanner and the smoother. The ROS node feeds it the maps and poses it receives,
+   the benchmarks feed it images from disk.
+*/
+class Planner {
+ public:
+  /// The default constructor
+  Planner() {}
+  /// The destructor freeing the node arrays and the lookup
+  ~Planner();
+
+  /// loads the Dubin's lookup from the file, building and saving it if there is no file matching the current constants, without it the closed form kernel is used
+  void initializeDubinsLookup(const std::string& file);
+
+  /*!
+     \brief Updates the configuration space and the Voronoi diagram as selected by `voronoiMode`
+
+     brushfire and exact rebuild the distance map and the diagram on every map.
+     incremental feeds the diagram only the cells that changed since the previous map. It rebuilds it like exact after a refused map,
+     a change of the size of the map or of more than `voronoiChangeShare` of its cells.
+     lazy builds no diagram, a distance is computed when the search or the smoother first queries its cell and every other cell stays at infinity.
+
+     \param gridmap the occupancy image, a cell (x,y) is occupied if the first channel of `gridmap.at<cv::Vec3b>(x,y)` is 255
+     \return false if the map is too large for the diagram, every plan fails until a map of a supported size is updated
+  */
+  bool updateMap(const cv::Mat& gridmap);
+
+  /*!
+     \brief Plans and smooths a path on the current map
+
+     \param start the start pose
+     \param goal the goal pose
+     \return whether a path has been found, false without a valid map
+  */
+  bool plan(Node3D& start, const Node3D& goal);
+
+  /// returns the path of the search, starting at the goal
+  const std::vector<Node3D>& getPath() const { return path; }
+  /// returns the smoothed path, starting at the goal
+  const std::vector<Node3D>& getSmoothedPath() const { return smoothedPath; }
+  /// returns the suboptimality bound of the path
+  float getBound() const { return bound; }
+  /// returns the configuration space of the current map
+  CollisionDetection& getConfigurationSpace() { return configurationSpace; }
+  /// returns the Voronoi diagram of the current map
+  DynamicVoronoi& getVoronoi() { return voronoiDiagram; }
+  /// returns the incremental replanner
+  Replanner& getReplanner() { return replanner; }
+
+  /// [s] --- The wall clock budget of a plan
+  double deadline = Constants::deadline;
+  /// The way the distance map follows the map, takes effect with the next map
+  Constants::VoronoiMode voronoiMode = Constants::voronoiMode;
+  /// The share of the cells of a map that may change for the incremental mode to update the diagram instead of rebuilding it
+  float voronoiChangeShare = Constants::voronoiChangeShare;
+
+ private:
+  /// forgets the refused map and the grid of the previous one, returns false
+  bool refuseMap();
+
+  /// the width of the current map in cells
+  int width = 0;
+  /// the height of the current map in cells
+  int height = 0;
+  /// whether the diagram holds the current map, false before the first map and after a map it refused
+  bool mapValid = false;
+  /// The collission detection for testing specific configurations
+  CollisionDetection configurationSpace;
+  /// The voronoi diagram
+  DynamicVoronoi voronoiDiagram;
+  /// The threads rebuilding the diagram
+  ThreadPool threadPool;
+  /// The grid the diagram was last updated with
+  BinaryGrid previousGrid;
+  /// The cells that changed between the previous and the current map
+  std::vector<BinaryGrid::Change> changedCells;
+  /// The smoother used for optimizing the path
+  Smoother smoother;
+  /// The incremental planner repairing the path of the previous map
+  Replanner replanner;
+  /// The lookup of the Dubin's distances
+  float* dubinsLookup = nullptr;
+  /// The 3D nodes, allocated once and invalidated per search through their generation
+  Node3D* nodes3D = nullptr;
+  /// The 2D nodes, allocated once and invalidated per search through their generation
+  Node2D* nodes2D = nullptr;
+  /// The open lists and the Dubin's shot storage of the searches on the node arrays
+  SearchContext searchContext;
+  /// The number of allocated 3D nodes
+  int nodes3DLength = 0;
+  /// The path of the search, starting at the goal
+  std::vector<Node3D> path;
+  /// The smoothed path, starting at the goal
+  std::vector<Node3D> smoothedPath;
+  /// The suboptimality bound of the path
+  float bound = 1.f;
+};
+}
+#endif // PLANNER_H
@@ -0,0 +1,59 @@
+#ifndef PRIMITIVES_H
+#define PRIMITIVES_H
+
+#include <cmath>
+
+#include "constants.h"
+namespace HybridAStar {
+/*!
+   \brief A table of the motion primitives of Node3D rotated into every discrete heading.
+
+   The headings form a lattice of one degree, which every heading resolution of Parameters divides.
+   For every lattice heading the table holds the displacement of the forward and reverse primitives as well as the
+   lattice heading of the successor, so creating a successor is a lookup and two additions instead of four trigonometric calls.
+   The table is built once at startup and can be used by anything else that needs the sine or cosine of a heading.
+*/
+class Primitives {
+ public:
+  /// [#] --- The number of discrete headings of the table
+  static const int bins = 360;
+  /// [#] --- The number of motion primitives, three forward and three reverse
+  static const int count = 6;
+  /// [c*M_PI] --- The heading difference between two lattice headings
+  static constexpr float deltaBinRad = 2 * M_PI / bins;
+
+  /// A motion primitive rotated into a lattice heading
+  struct Primitive {
+    /// the displacement in x
+    float dx;
+    /// the displacement in y
+    float dy;
+    /// the lattice heading of the successor
+    int bin;
+  };
+
+  /// get the lattice heading closest to the heading t in rad, normalized to [0,2PI]
+  static int bin(float t) { return (int)(t / deltaBinRad + 0.5f) % bins; }
+  /// get the heading of a lattice heading in rad
+  static float heading(int bin) { return bin * deltaBinRad; }
+  /// get the cosine of a lattice heading
+  static float cos(int bin) { return cosTable[bin]; }
+  /// get the sine of a lattice heading
+  static float sin(int bin) { return sinTable[bin]; }
+  /// get the motion primitive i rotated into the lattice heading bin
+  static const Primitive& get(int bin, int i) { return table[bin][i]; }
+
+ private:
+  /// builds the tables, called once during static initialization
+  static bool build();
+  /// the motion primitives for every lattice heading
+  static Primitive table[bins][count];
+  /// the cosine of every lattice heading
+  static float cosTable[bins];
+  /// the sine of every lattice heading
+  static float sinTable[bins];
+  /// set once the tables are built
+  static const bool built;
+};
+}
+#endif // PRIMITIVES_H
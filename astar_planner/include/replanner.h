@@ -0,0 +1,83 @@
+#ifndef REPLANNER_H
+#define REPLANNER_H
+
+#include <vector>
+
+#include "algorithm.h"
+#include "collisiondetection.h"
+#include "node2d.h"
+#include "node3d.h"
+
+namespace HybridAStar {
+/*!
+   \brief Replans incrementally by repairing the path of the previous map instead of searching from scratch.
+
+   Successive maps are centred on the vehicle and differ by the ego-motion and a few obstacle cells.
+   The previous path is therefore shifted into the frame of the new map, cut at the new start and validated against the new
+   configuration space. The start is joined onto the path by a straight segment, which is sampled and tested like a Dubin's shot.
+   A valid path is reused as it is. If it is blocked, only the part from the start up to the first node
+   Constants::replanMargin cells behind the blocked part is searched again and the rest of the previous path is kept.
+   If the start strays from the path, the goal moves or the blocked part reaches the goal the planner falls back to a full plan.
+
+   The search tree of the previous map is not reused, as its nodes are binned in the lattice of the previous frame,
+   which is rotated and shifted by a fraction of a cell against the new one.
+*/
+class Replanner {
+ public:
+  /// The default constructor
+  Replanner() {}
+
+  /*!
+     \brief Shifts the previous path into the frame of the new map
+
+     \param from the pose of the vehicle at the time of the new map in the frame of the previous map
+     \param to the same pose in the frame of the new map
+  */
+  void shift(const Node3D& from, const Node3D& to);
+
+  /*!
+     \brief Plans a path reusing the path of the previous map where possible
+
+     \param start the start pose
+     \param goal the goal pose
+     \param nodes3D the array of 3D nodes representing the configuration space C in R^3
+     \param nodes2D the array of 2D nodes representing the configuration space C in R^2
+     \param context the open lists and the Dubin's shot storage of the search
+     \param width the width of the grid in number of cells
+     \param height the height of the grid in number of cells
+     \param configurationSpace the lookup of configurations and their spatial occupancy enumeration
+     \param dubinsLookup the lookup of analytical solutions (Dubin's paths), nullptr uses the closed form kernel
+     \param deadline [s] the wall clock budget of the plan
+     \param path the path found, starting at the goal like Smoother::tracePath
+     \param bound the suboptimality bound of the path, the largest bound of the searches its parts stem from
+     \return whether a path has been found
+  */
+  bool plan(Node3D& start,
+            const Node3D& goal,
+            Node3D* nodes3D,
+            Node2D* nodes2D,
+            SearchContext& context,
+            int width,
+            int height,
+            CollisionDetection& configurationSpace,
+            float* dubinsLookup,
+            double deadline,
+            std::vector<Node3D>& path,
+            float& bound);
+
+  /// forgets the previous path, so the next plan starts from scratch
+  void reset() { previous.clear(); }
+
+ private:
+  /// finds the index of the first node of the previous path ahead of the start, -1 if the start is not on the path
+  int rejoin(const Node3D& start) const;
+
+  /// the path of the previous plan, starting at the goal
+  std::vector<Node3D> previous;
+  /// the goal of the previous plan
+  Node3D previousGoal;
+  /// the suboptimality bound of the previous path
+  float previousBound = 1.f;
+};
+}
+#endif // REPLANNER_H
@@ -41,6 +41,9 @@ class Smoother {
   //
   void tracePath(const Node3D* node, int i = 0, std::vector<Node3D> path = std::vector<Node3D>());
 
+  /// sets the path of the smoother object, starting at the goal like tracePath
+  void setPath(const std::vector<Node3D>& path) {this->path = path;}
+
   /// returns the path of the smoother object
   std::vector<Node3D> getPath() {return path;}
 
@@ -82,8 +85,8 @@ class Smoother {
   float wCurvature = 0;
   /// weight for the smoothness term
   float wSmoothness = 0.2;
-  /// voronoi diagram describing the topology of the map
-  DynamicVoronoi voronoi;
+  /// voronoi diagram describing the topology of the map, owned by the caller of smoothPath
+  DynamicVoronoi* voronoi = nullptr;
   /// width of the map
   int width;
   /// height of the map
@@ -0,0 +1,117 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <chrono>
+#include <ostream>
+
+/*!
+   \brief The instrumentation macros of the planner hot path
+
+   The counters and phase timers are only compiled in if ASTAR_PLANNER_STATS is defined (cmake -DASTAR_PLANNER_STATS=ON),
+   otherwise every macro expands to nothing, so a release build does not pay for a single increment.
+*/
+#ifdef ASTAR_PLANNER_STATS
+/// increments a counter of the current plan
+#define STATS_COUNT(counter) (++HybridAStar::PlannerStats::current.counter)
+/// adds a value to a counter of the current plan
+#define STATS_ADD(counter, value) (HybridAStar::PlannerStats::current.counter += (value))
+/// adds the time until the end of the enclosing scope to a phase of the current plan
+#define STATS_TIMER(phase) HybridAStar::PlannerStats::Timer statsTimer##phase(HybridAStar::PlannerStats::current.phase)
+#else
+#define STATS_COUNT(counter) ((void)0)
+#define STATS_ADD(counter, value) ((void)0)
+#define STATS_TIMER(phase) ((void)0)
+#endif
+
+namespace HybridAStar {
+/*!
+   \brief The statistics of a single plan, filled by the search, the heuristics, the collision checks and the smoother.
+
+   The planner resets PlannerStats::current at the start of every plan and publishes or dumps it once the plan is done.
+*/
+struct PlannerStats {
+  // _______________
+  // 3D SEARCH
+  /// [#] --- The number of restarts of the hybrid A*, more than one for the anytime search
+  long searches = 0;
+  /// [#] --- The number of nodes expanded by the hybrid A*
+  long expansions = 0;
+  /// [#] --- The number of nodes pushed on the open list of the hybrid A*
+  long pushes = 0;
+  /// [#] --- The number of stale open list entries discarded by the hybrid A*
+  long lazyDeletions = 0;
+  /// [#] --- The number of successors pruned by the cost of the best path of the anytime search
+  long pruned = 0;
+  // _______________
+  // 2D SEARCH
+  /// [#] --- The number of 2D searches, one per undiscovered cell or one field per plan
+  long twoDSearches = 0;
+  /// [#] --- The number of nodes expanded by the 2D searches
+  long twoDExpansions = 0;
+  /// [#] --- The number of nodes pushed on the open list of the 2D searches
+  long twoDPushes = 0;
+  // _______________
+  // HEURISTICS AND CHECKS
+  /// [#] --- The number of evaluations of the cost-to-go
+  long heuristicEvaluations = 0;
+  /// [#] --- The number of Dubin's shots
+  long dubinsShots = 0;
+  /// [#] --- The number of Dubin's shots reaching the goal without collision
+  long dubinsShotsConnected = 0;
+  /// [#] --- The number of configurations checked for collisions
+  long collisionChecks = 0;
+  /// [#] --- The number of gradient descent iterations of the smoother
+  long smootherIterations = 0;
+  // _______________
+  // RESULT
+  /// [#] --- The number of nodes of the path
+  long pathLength = 0;
+  /// [#] --- The cost of the path
+  float pathCost = 0;
+  /// [#] --- The suboptimality bound of the path
+  float bound = 0;
+  // _______________
+  // PHASES
+  /// [ms] --- The time spent building the Voronoi diagram
+  double voronoiTime = 0;
+  /// [ms] --- The time spent searching, including the heuristics
+  double searchTime = 0;
+  /// [ms] --- The time spent sweeping the 2D cost-to-goal field
+  double twoDTime = 0;
+  /// [ms] --- The time spent smoothing the path
+  double smoothingTime = 0;
+  /// [ms] --- The time of the whole plan
+  double totalTime = 0;
+
+  /// clears all counters and timers
+  void reset() { *this = PlannerStats(); }
+
+  /// writes the names of the columns of toCsv
+  static void csvHeader(std::ostream& out);
+  /// writes the statistics as one comma separated line
+  void toCsv(std::ostream& out) const;
+  /// appends the statistics to a CSV file, writing the header first if the file is new
+  bool appendCsv(const char* file) const;
+
+  /*!
+     \brief Adds the time between its construction and destruction to a phase
+  */
+  class Timer {
+   public:
+    /// starts timing a phase
+    explicit Timer(double& phase) : phase(phase), t0(std::chrono::steady_clock::now()) {}
+    /// adds the elapsed time in ms to the phase
+    ~Timer() { phase += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count(); }
+
+   private:
+    /// the phase the time is added to
+    double& phase;
+    /// the start of the phase
+    std::chrono::steady_clock::time_point t0;
+  };
+
+  /// The statistics of the current plan
+  static PlannerStats current;
+};
+}
+#endif // STATS_H
@@ -0,0 +1,72 @@
+#ifndef SWEPTVOLUME_H
+#define SWEPTVOLUME_H
+
+#include <cstdint>
+#include <vector>
+
+#include "constants.h"
+#include "primitives.h"
+
+namespace HybridAStar {
+/*!
+   \brief A table of the cells the vehicle sweeps between a node and its successor, for every motion primitive and lattice heading.
+
+   A successor lies 5.5 cells from its predecessor, so testing the footprint at the successor alone can tunnel through thin obstacles.
+   For every lattice heading of the predecessor and every primitive the footprints of the collision lookup at the poses between the two nodes,
+   about half a cell apart, are merged into a bit mask per row, the endpoints are left to the tests of the nodes themselves.
+   The position of the predecessor within its cell is split into `buckets` x `buckets` parts and the mask of a part is the union of
+   the masks of the discrete positions of the collision lookup within it.
+   A row wider than a word of the grid spans several words, so the masks hold the footprint of any vehicle.
+   The table is built once per process on its first use, for the footprint of the parameters of the process.
+*/
+class SweptVolume {
+ public:
+  /// [#] --- The number of parts of the position within a cell per dimension
+  static const int buckets = 2;
+  /// [#] --- The number of motion primitives of the table
+  static const int count = Constants::reverse ? Primitives::count : Primitives::count / 2;
+
+  /// The cells swept by a primitive as a bit mask per row of its bounding box
+  struct Mask {
+    /// the row of the bounding box relative to the cell of the predecessor
+    int x;
+    /// the column of the bounding box relative to the cell of the predecessor
+    int y;
+    /// the number of rows of the bounding box
+    int rows;
+    /// the number of words of a row
+    int words;
+    /// the index of the first word of the first row
+    int offset;
+  };
+
+  /// returns the table shared by all configuration spaces, building it on the first call
+  static const SweptVolume& shared();
+
+  /*!
+     \brief Returns the cells swept by the primitive i from the pose (x,y) with the lattice heading bin
+     \param x the x position of the predecessor, the swept cells are relative to the cell (int)x
+     \param y the y position of the predecessor, the swept cells are relative to the cell (int)y
+  */
+  const Mask& get(float x, float y, int bin, int i) const {
+    int bX = (int)((x - (long)x) * buckets);
+    int bY = (int)((y - (long)y) * buckets);
+    bX = bX > 0 ? (bX < buckets ? bX : buckets - 1) : 0;
+    bY = bY > 0 ? (bY < buckets ? bY : buckets - 1) : 0;
+    return masks[((bin * count + i) * buckets + bY) * buckets + bX];
+  }
+
+  /// returns the bit masks of the rows of a mask, `words` per row, the cell in the column of the bounding box in the lowest bit of the first
+  const uint64_t* getRows(const Mask& mask) const { return &words[mask.offset]; }
+
+ private:
+  /// builds the table from the shared collision lookup
+  SweptVolume();
+
+  /// the masks of every lattice heading, primitive and part of the cell
+  std::vector<Mask> masks;
+  /// the bit masks of the rows of all masks
+  std::vector<uint64_t> words;
+};
+}
+#endif // SWEPTVOLUME_H
@@ -0,0 +1,67 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace HybridAStar {
+/*!
+   \brief A fixed set of threads splitting loops over independent ranges.
+
+   The calling thread works on the loop as well, so a pool of one thread runs the loop inline without any synchronization.
+*/
+class ThreadPool {
+ public:
+  /// A function working on the indices [begin, end) of a loop
+  typedef std::function<void(int begin, int end)> Range;
+
+  /// starts the threads, 0 uses one thread per core
+  explicit ThreadPool(int threads = 0);
+  /// stops the threads
+  ~ThreadPool();
+
+  /// returns the number of threads working on a loop, including the calling one
+  int size() const { return (int)workers.size() + 1; }
+
+  /*!
+     \brief Runs a loop over the indices [0, n) split into chunks and returns once every chunk is done
+
+     \param n the number of indices
+     \param range the function working on a chunk, it is called concurrently for disjoint chunks
+  */
+  void parallelFor(int n, const Range& range);
+
+ private:
+  /// takes chunks of the current loop until none is left, returns whether it worked on one
+  bool work();
+  /// waits for loops and works on them until the pool is destroyed
+  void run();
+
+  /// the threads besides the calling one
+  std::vector<std::thread> workers;
+  /// guards the state of the current loop
+  std::mutex mutex;
+  /// wakes the workers for a loop
+  std::condition_variable start;
+  /// wakes the calling thread once the loop is done
+  std::condition_variable done;
+  /// the function of the current loop
+  const Range* range = nullptr;
+  /// the number of indices of the current loop
+  int n = 0;
+  /// the number of indices per chunk
+  int chunk = 0;
+  /// the first index not taken by a thread yet
+  int next = 0;
+  /// the number of chunks in progress
+  int busy = 0;
+  /// counts the loops, so a worker only joins a loop once
+  unsigned generation = 0;
+  /// set when the pool is destroyed
+  bool stop = false;
+};
+}
+#endif // THREADPOOL_H
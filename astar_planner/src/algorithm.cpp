@@ -1,29 +1,20 @@
 #include "algorithm.h"
+#include "heuristic.h"
+#include "clock.h"
+#include "lookup.h"
+#include "stats.h"
 #include "zdebug.h"
-#include <boost/heap/binomial_heap.hpp>
+#include <limits>
 
 using namespace HybridAStar;
 
-float aStar(Node2D& start, Node2D& goal, Node2D* nodes2D, int width, int height, CollisionDetection& configurationSpace);
-void updateH(Node3D& start, const Node3D& goal, Node2D* nodes2D, float* dubinsLookup, int width, int height, CollisionDetection& configurationSpace);
-Node3D* dubinsShot(Node3D& start, const Node3D& goal, CollisionDetection& configurationSpace);
-
-//###################################################
-//                                    NODE COMPARISON
-//###################################################
-/*!
-   \brief A structure to sort nodes in a heap structure
-*/
-struct CompareNodes {
-  /// Sorting 3D nodes by increasing C value - the total estimated cost
-  bool operator()(const Node3D* lhs, const Node3D* rhs) const {
-    return lhs->getC() > rhs->getC();
-  }
-  /// Sorting 2D nodes by increasing C value - the total estimated cost
-  bool operator()(const Node2D* lhs, const Node2D* rhs) const {
-    return lhs->getC() > rhs->getC();
-  }
-};
+float aStar(Node2D& start, Node2D& goal, Node2D* nodes2D, SearchContext& context, int width, int height, CollisionDetection& configurationSpace);
+void twoDField(const Node3D& goal, Node2D* nodes2D, SearchContext& context, int width, int height, CollisionDetection& configurationSpace);
+void preparePlan(const Node3D& goal, Node2D* nodes2D, SearchContext& context, int width, int height, CollisionDetection& configurationSpace);
+Node3D* weightedHybridAStar(Node3D& start, const Node3D& goal, Node3D* nodes3D, Node2D* nodes2D, SearchContext& context, int width, int height,
+                            CollisionDetection& configurationSpace, float* dubinsLookup, float inflation, float incumbent, double deadline, bool& complete);
+void updateH(Node3D& start, const Node3D& goal, Node2D* nodes2D, SearchContext& context, float* dubinsLookup, int width, int height, CollisionDetection& configurationSpace);
+Node3D* dubinsShot(Node3D& start, const Node3D& goal, SearchContext& context, CollisionDetection& configurationSpace);
 
 //###################################################
 //                                        3D A*
@@ -32,10 +23,148 @@ Node3D* Algorithm::hybridAStar(Node3D& start,
                                const Node3D& goal,
                                Node3D* nodes3D,
                                Node2D* nodes2D,
+                               SearchContext& context,
                                int width,
                                int height,
                                CollisionDetection& configurationSpace,
                                float* dubinsLookup) {
+  bool complete;
+  preparePlan(goal, nodes2D, context, width, height, configurationSpace);
+  return weightedHybridAStar(start, goal, nodes3D, nodes2D, context, width, height, configurationSpace, dubinsLookup,
+                             1.f, std::numeric_limits<float>::infinity(), Constants::deadline, complete);
+}
+
+//###################################################
+//                                    ANYTIME 3D A*
+//###################################################
+bool Algorithm::anytimeHybridAStar(Node3D& start,
+                                   const Node3D& goal,
+                                   Node3D* nodes3D,
+                                   Node2D* nodes2D,
+                                   SearchContext& context,
+                                   int width,
+                                   int height,
+                                   CollisionDetection& configurationSpace,
+                                   float* dubinsLookup,
+                                   double deadline,
+                                   std::vector<Node3D>& path,
+                                   float& bound) {
+  double t0 = Clock::now();
+  // the cost of the best path found so far
+  float incumbent = std::numeric_limits<float>::infinity();
+  float inflation = Constants::inflation;
+  bool complete;
+
+  path.clear();
+  bound = std::numeric_limits<float>::infinity();
+  preparePlan(goal, nodes2D, context, width, height, configurationSpace);
+
+  while (true) {
+    double elapsed = Clock::now() - t0;
+
+    if (elapsed >= deadline) {
+      break;
+    }
+
+    Node3D* nSolution = weightedHybridAStar(start, goal, nodes3D, nodes2D, context, width, height, configurationSpace, dubinsLookup,
+                                            inflation, incumbent, deadline - elapsed, complete);
+
+    // keep a copy of the path, the next search overwrites the nodes
+    if (nSolution != nullptr && nSolution->getG() < incumbent) {
+      incumbent = nSolution->getG();
+      path.clear();
+
+      for (const Node3D* node = nSolution; node != nullptr; node = node->getPred()) {
+        path.push_back(*node);
+      }
+    }
+
+    // a completed search without a path proved the goal unreachable, the inflation does not change the reachable states
+    if (!complete || path.empty()) {
+      break;
+    }
+
+    // a search running out of nodes pruned everything not cheaper than the incumbent, so no cheaper path exists
+    if (nSolution == nullptr) {
+      bound = 1.f;
+      break;
+    }
+
+    // a completed search either improved on the incumbent or proved it to be within its inflation
+    bound = inflation;
+
+    if (inflation <= 1.f) {
+      break;
+    }
+
+    inflation = std::max(1.f, inflation - Constants::inflationStep);
+  }
+
+  return !path.empty();
+}
+
+//###################################################
+//                                             SEARCH
+//###################################################
+bool Algorithm::search(Node3D& start,
+                       const Node3D& goal,
+                       Node3D* nodes3D,
+                       Node2D* nodes2D,
+                       SearchContext& context,
+                       int width,
+                       int height,
+                       CollisionDetection& configurationSpace,
+                       float* dubinsLookup,
+                       double deadline,
+                       std::vector<Node3D>& path,
+                       float& bound) {
+  if (Constants::anytime) {
+    return anytimeHybridAStar(start, goal, nodes3D, nodes2D, context, width, height, configurationSpace, dubinsLookup, deadline, path, bound);
+  }
+
+  bool complete;
+  preparePlan(goal, nodes2D, context, width, height, configurationSpace);
+  path.clear();
+  bound = 1.f;
+
+  for (const Node3D* node = weightedHybridAStar(start, goal, nodes3D, nodes2D, context, width, height, configurationSpace, dubinsLookup,
+                                                1.f, std::numeric_limits<float>::infinity(), deadline, complete);
+       node != nullptr; node = node->getPred()) {
+    path.push_back(*node);
+  }
+
+  return !path.empty();
+}
+
+//###################################################
+//                                        PLAN SETUP
+//###################################################
+void preparePlan(const Node3D& goal, Node2D* nodes2D, SearchContext& context, int width, int height, CollisionDetection& configurationSpace) {
+  // START A NEW PLAN, invalidating the 2D nodes of the previous plan
+  Node2D::nextPlan();
+
+  // sweep the 2D cost-to-goal field once for the whole plan
+  if (Constants::twoDField) {
+    twoDField(goal, nodes2D, context, width, height, configurationSpace);
+  }
+}
+
+//###################################################
+//                                       WEIGHTED 3D A*
+//###################################################
+Node3D* weightedHybridAStar(Node3D& start,
+                            const Node3D& goal,
+                            Node3D* nodes3D,
+                            Node2D* nodes2D,
+                            SearchContext& context,
+                            int width,
+                            int height,
+                            CollisionDetection& configurationSpace,
+                            float* dubinsLookup,
+                            float inflation,
+                            float incumbent,
+                            double deadline,
+                            bool& complete) {
 
   std::cout<<"new hybridAStar"<<std::endl;
   // PREDECESSOR AND SUCCESSOR INDEX
@@ -46,38 +175,45 @@ Node3D* Algorithm::hybridAStar(Node3D& start,
   // Number of iterations the algorithm has run for stopping based on Constants::iterations
   int iterations = 0;
 
-  // OPEN LIST AS BOOST IMPLEMENTATION
-  typedef boost::heap::binomial_heap<Node3D*,
-          boost::heap::compare<CompareNodes>
-          > priorityQueue;
-  priorityQueue O;
+  // OPEN LIST, owned by the caller to reuse its storage across searches
+  OpenList<Node3D>::type& O = context.open3D;
+  O.clear();
+  // START A NEW SEARCH, invalidating the nodes of the previous search
+  Node3D::nextGeneration();
+  STATS_COUNT(searches);
+  // the search is complete unless it is aborted
+  complete = false;
 
   // update h value
 
-  updateH(start, goal, nodes2D, dubinsLookup, width, height, configurationSpace);
+  updateH(start, goal, nodes2D, context, dubinsLookup, width, height, configurationSpace);
+  start.setH(start.getH() * inflation);
   //std::cout<<"width and height are "<<width <<", "<<height<<std::endl;
   //std::cout<<"hybridAStar updateH finished"<<std::endl;
   // mark start as open
   start.open();
-  // push on priority queue aka open list
-  //std::cout<<"start open complete"<<std::endl;
+  iPred = start.setIdx(width, height);
+  //std::cout<<"iPred set to "<<iPred<<std::endl;
 
+  // push on priority queue aka open list
   O.push(&start);
+  STATS_COUNT(pushes);
   //std::cout<<"O push start"<<std::endl;
 
-  iPred = start.setIdx(width, height);
-  //std::cout<<"iPred set to "<<iPred<<std::endl;
-
   nodes3D[iPred] = start;
   //std::cout<<"set nodes3D[iPred] to start"<<std::endl;
 
   // NODE POINTER
   Node3D* nPred;
   Node3D* nSucc;
+  // SCRATCH NODES the successors are written into, avoiding a heap allocation per motion primitive
+  Node3D successors[Primitives::count];
+  // whether the successors are traversable, tested at once
+  uint8_t traversable[Primitives::count];
 
   // float max = 0.f;
   double progress_time =0.0;
-  ros::Time t0 = ros::Time::now();
+  double t0 = Clock::now();
 
   // continue until O empty
   while (!O.empty()) {
@@ -140,11 +276,10 @@ Node3D* Algorithm::hybridAStar(Node3D& start,
     iPred = nPred->setIdx(width, height);
     iterations++;
     //std::cout<<"one while loop has ended!"<<std::endl;
-    ros::Time t1 = ros::Time::now();
-    //std::cout<<"hybridAstar to much time spent: "<<progress_time<<std::endl;
-    ros::Duration d(t1-t0);
-    progress_time = progress_time + d.toSec();
-    t0 = t1;
+    // read the clock only every few iterations, it is not free either
+    if ((iterations & (Constants::clockInterval - 1)) == 0) {
+      progress_time = Clock::now() - t0;
+    }
     // // RViz visualization
     // if (Constants::visualization) {
     //   visualization.publishNode3DPoses(*nPred);
@@ -158,6 +293,7 @@ Node3D* Algorithm::hybridAStar(Node3D& start,
     if (nodes3D[iPred].isClosed()) {
       // pop node from the open list and start with a fresh node
       O.pop();
+      STATS_COUNT(lazyDeletions);
       //std::cout<<"PoP3 ";
       //std::cout<<" size of pQueue: "<<O.size()<<std::endl;
       continue;
@@ -169,10 +305,11 @@ Node3D* Algorithm::hybridAStar(Node3D& start,
       nodes3D[iPred].close();
       // remove node from open list
       O.pop();
+      STATS_COUNT(expansions);
       //std::cout<<"PoP4 ";
       //std::cout<<" size of pQueue: "<<O.size()<<std::endl;
 
-      if(progress_time >= 0.5) {
+      if(progress_time >= deadline) {
         std::cout<<"hybridAstar too much time spent: "<<progress_time<<std::endl;
         return nullptr;
       }
@@ -182,6 +319,7 @@ Node3D* Algorithm::hybridAStar(Node3D& start,
       if (*nPred == goal) {
         // DEBUG
         std::cout<<"hybridAstar total iterations: "<<iterations<<std::endl;
+        complete = true;
         return nPred;//original code
       }
       else if (iterations > Constants::iterations) {
@@ -195,25 +333,31 @@ Node3D* Algorithm::hybridAStar(Node3D& start,
         // _______________________
         // SEARCH WITH DUBINS SHOT
         if (Constants::dubinsShot && nPred->isInRange(goal) && nPred->getPrim() < 3) {
-          nSucc = dubinsShot(*nPred, goal, configurationSpace);
+          nSucc = dubinsShot(*nPred, goal, context, configurationSpace);
 
           if (nSucc != nullptr && *nSucc == goal) {
             //DEBUG
             // std::cout << "max diff " << max << std::endl;
+            complete = true;
             return nSucc;
           }
         }
 
         // ______________________________
         // SEARCH WITH FORWARD SIMULATION
+        // create possible successors and test them at once
+        for (int i = 0; i < dir; i++) { nPred->createSuccessor(i, &successors[i]); }
+
+        configurationSpace.traversableMask(successors, dir, traversable);
+
         for (int i = 0; i < dir; i++) {
-          // create possible successor
-          nSucc = nPred->createSuccessor(i);
+          nSucc = &successors[i];
           // set index of the successor
           iSucc = nSucc->setIdx(width, height);
 
-          // ensure successor is on grid and traversable
-          if (nSucc->isOnGrid(width, height) && configurationSpace.isTraversable(nSucc)) {
+          // ensure successor is on grid and traversable, as well as the cells swept on the way
+          if (nSucc->isOnGrid(width, height) && traversable[i]
+              && (!Constants::sweptCollision || configurationSpace.isTraversable(nPred, i))) {
 
             // ensure successor is not on closed list or it has the same index as the predecessor
             if (!nodes3D[iSucc].isClosed() || iPred == iSucc) {
@@ -226,12 +370,20 @@ Node3D* Algorithm::hybridAStar(Node3D& start,
               if (!nodes3D[iSucc].isOpen() || newG < nodes3D[iSucc].getG() || iPred == iSucc) {
 
                 // calculate H value
-                updateH(*nSucc, goal, nodes2D, dubinsLookup, width, height, configurationSpace);
+                updateH(*nSucc, goal, nodes2D, context, dubinsLookup, width, height, configurationSpace);
+
+                // prune the successor if it cannot improve on the best path found so far
+                if (newG + nSucc->getH() >= incumbent) {
+                  STATS_COUNT(pruned);
+                  continue;
+                }
+
+                // inflate the heuristic of a weighted search
+                nSucc->setH(nSucc->getH() * inflation);
                 //std::cout<<"size of the priorityQueue is "<<O.size()<<std::endl;
                 //std::cout<<"updateH finished in while loop"<<std::endl;
                 // if the successor is in the same cell but the C value is larger
                 if (iPred == iSucc && nSucc->getC() > nPred->getC() + Constants::tieBreaker) {
-                  delete nSucc;
                   continue;
                 }
                 // if successor is in the same cell and the C value is lower, set predecessor to predecessor of predecessor
@@ -247,10 +399,10 @@ Node3D* Algorithm::hybridAStar(Node3D& start,
                 nSucc->open();
                 nodes3D[iSucc] = *nSucc;
                 O.push(&nodes3D[iSucc]);
-                delete nSucc;
-              } else { delete nSucc; }
-            } else { delete nSucc; }
-          } else { delete nSucc; }
+                STATS_COUNT(pushes);
+              }
+            }
+          }
         }
       }
     }
@@ -259,6 +411,7 @@ Node3D* Algorithm::hybridAStar(Node3D& start,
   if (O.empty()) {
     std::cout<<"hybridAstar total iterations: "<<iterations<<std::endl;
     std::cout<<"null pointer condition: O.empty()"<<std::endl;
+    complete = true;
     return nullptr;
   }
   std::cout<<"hybridAstar total iterations: "<<iterations<<std::endl;
@@ -273,6 +426,7 @@ Node3D* Algorithm::hybridAStar(Node3D& start,
 float aStar(Node2D& start,
             Node2D& goal,
             Node2D* nodes2D,
+            SearchContext& context,
             int width,
             int height,
             CollisionDetection& configurationSpace) {
@@ -282,28 +436,27 @@ float aStar(Node2D& start,
   float newG;
 
   // reset the open and closed list
-  for (int i = 0; i < width * height; ++i) {
-    nodes2D[i].reset();
-  }
+  Node2D::nextSearch();
+  STATS_COUNT(twoDSearches);
 
-  // VISUALIZATION DELAY
-  ros::Duration d(0.001);
-
-  boost::heap::binomial_heap<Node2D*,
-        boost::heap::compare<CompareNodes>> O;
+  // OPEN LIST, owned by the caller to reuse its storage across searches
+  OpenList<Node2D>::type& O = context.open2D;
+  O.clear();
   // update h value
   start.updateH(goal);
 
   // mark start as open
   start.open();
-  // push on priority queue
-  O.push(&start);
   iPred = start.setIdx(width);
+  // push the entry of the array on priority queue, the successors keep it as their predecessor
   nodes2D[iPred] = start;
+  O.push(&nodes2D[iPred]);
 
   // NODE POINTER
   Node2D* nPred;
   Node2D* nSucc;
+  // SCRATCH NODE the successors are written into, avoiding a heap allocation per direction
+  Node2D successor;
 
   // continue until O empty
   while (!O.empty()) {
@@ -333,6 +486,7 @@ float aStar(Node2D& start,
       // add node to closed list
       nodes2D[iPred].close();
       nodes2D[iPred].discover();
+      STATS_COUNT(twoDExpansions);
 
       // RViz visualization
       // if (Constants::visualization2D) {
@@ -351,8 +505,6 @@ float aStar(Node2D& start,
       // _________
       // GOAL TEST
       if (*nPred == goal) {
-        std::cout<<"nPred is ("<<nPred->getX()<<", "<<nPred->getY()<<") so it is the goal, ";
-        std::cout<<"and the cost to there is "<<nPred->getG()<<std::endl;
         return nPred->getG();
       }
       // ____________________
@@ -366,7 +518,7 @@ float aStar(Node2D& start,
           // create possible successor
           //std::cout<<"aStar for loop starts"<<std::endl;
 
-          nSucc = nPred->createSuccessor(i);
+          nSucc = nPred->createSuccessor(i, &successor);
           //std::cout<<"nPred createSuccessor"<<std::endl;
 
           // set index of the successor
@@ -395,12 +547,9 @@ float aStar(Node2D& start,
               nSucc->open();
               nodes2D[iSucc] = *nSucc;
               O.push(&nodes2D[iSucc]);
-              delete nSucc;
-            } else { //std::cout<<"second else condition"<<std::endl;
-            delete nSucc;
+              STATS_COUNT(twoDPushes);
             }
-          } else { //std::cout<<"first else condition"<<std::endl;
-          delete nSucc;}
+          }
         }
       }
     }
@@ -410,11 +559,80 @@ float aStar(Node2D& start,
   return 1000;
 }
 
+//###################################################
+//                                       2D COST FIELD
+//###################################################
+void twoDField(const Node3D& goal, Node2D* nodes2D, SearchContext& context, int width, int height, CollisionDetection& configurationSpace) {
+  // PREDECESSOR AND SUCCESSOR INDEX
+  int iPred, iSucc;
+  float newG;
+
+  STATS_TIMER(twoDTime);
+  // START A NEW SEARCH, the field of the previous plan has been invalidated by Node2D::nextPlan()
+  Node2D::nextSearch();
+  STATS_COUNT(twoDSearches);
+
+  // OPEN LIST, owned by the caller to reuse its storage across plans
+  OpenList<Node2D>::type& O = context.open2D;
+  O.clear();
+
+  // the sweep starts at the goal, without a heuristic the C value is the cost-to-goal
+  Node2D start(goal.getX(), goal.getY(), 0, 0, nullptr);
+  start.open();
+  start.discover();
+  iPred = start.setIdx(width);
+  // push the entry of the array, the successors keep it as their predecessor after the sweep returns
+  nodes2D[iPred] = start;
+  O.push(&nodes2D[iPred]);
+
+  // NODE POINTER
+  Node2D* nPred;
+  Node2D* nSucc;
+  // SCRATCH NODE the successors are written into
+  Node2D successor;
+
+  // Dijkstra until every reachable cell is closed
+  while (!O.empty()) {
+    nPred = O.top();
+    iPred = nPred->setIdx(width);
+    O.pop();
+
+    // LAZY DELETION of rewired node, only needed by the binomial heap
+    if (nodes2D[iPred].isClosed()) {
+      continue;
+    }
+
+    // add node to closed list, its g value is final
+    nodes2D[iPred].close();
+    STATS_COUNT(twoDExpansions);
+
+    for (int i = 0; i < Node2D::dir; i++) {
+      nSucc = nPred->createSuccessor(i, &successor);
+      iSucc = nSucc->setIdx(width);
+
+      // ensure successor is on grid, not blocked by obstacle and not on closed list
+      if (nSucc->isOnGrid(width, height) && !nodes2D[iSucc].isClosed() && configurationSpace.isTraversable(nSucc)) {
+        nSucc->updateG();
+        newG = nSucc->getG();
+
+        // if successor not on open list or g value lower than before put it on open list
+        if (!nodes2D[iSucc].isOpen() || newG < nodes2D[iSucc].getG()) {
+          nSucc->open();
+          nodes2D[iSucc] = *nSucc;
+          O.push(&nodes2D[iSucc]);
+          STATS_COUNT(twoDPushes);
+        }
+      }
+    }
+  }
+}
+
 //###################################################
 //                                         COST TO GO
 //###################################################
-void updateH(Node3D& start, const Node3D& goal, Node2D* nodes2D, float* dubinsLookup, int width, int height, CollisionDetection& configurationSpace) {
+void updateH(Node3D& start, const Node3D& goal, Node2D* nodes2D, SearchContext& context, float* dubinsLookup, int width, int height, CollisionDetection& configurationSpace) {
   //std::cout<<"updateH started"<<std::endl;
+  STATS_COUNT(heuristicEvaluations);
   float dubinsCost = 0;
   float reedsSheppCost = 0;
   float twoDCost = 0;
@@ -424,83 +642,21 @@ void updateH(Node3D& start, const Node3D& goal, Node2D* nodes2D, float* dubinsLo
   // constrained without obstacles
   if (Constants::dubins) {
 
-    // ONLY FOR dubinsLookup
-    //    int uX = std::abs((int)goal.getX() - (int)start.getX());
-    //    int uY = std::abs((int)goal.getY() - (int)start.getY());
-    //    // if the lookup table flag is set and the vehicle is in the lookup area
-    //    if (Constants::dubinsLookup && uX < Constants::dubinsWidth - 1 && uY < Constants::dubinsWidth - 1) {
-    //      int X = (int)goal.getX() - (int)start.getX();
-    //      int Y = (int)goal.getY() - (int)start.getY();
-    //      int h0;
-    //      int h1;
-
-    //      // mirror on x axis
-    //      if (X >= 0 && Y <= 0) {
-    //        h0 = (int)(helper::normalizeHeadingRad(M_PI_2 - t) / Constants::deltaHeadingRad);
-    //        h1 = (int)(helper::normalizeHeadingRad(M_PI_2 - goal.getT()) / Constants::deltaHeadingRad);
-    //      }
-    //      // mirror on y axis
-    //      else if (X <= 0 && Y >= 0) {
-    //        h0 = (int)(helper::normalizeHeadingRad(M_PI_2 - t) / Constants::deltaHeadingRad);
-    //        h1 = (int)(helper::normalizeHeadingRad(M_PI_2 - goal.getT()) / Constants::deltaHeadingRad);
-
-    //      }
-    //      // mirror on xy axis
-    //      else if (X <= 0 && Y <= 0) {
-    //        h0 = (int)(helper::normalizeHeadingRad(M_PI - t) / Constants::deltaHeadingRad);
-    //        h1 = (int)(helper::normalizeHeadingRad(M_PI - goal.getT()) / Constants::deltaHeadingRad);
-
-    //      } else {
-    //        h0 = (int)(t / Constants::deltaHeadingRad);
-    //        h1 = (int)(goal.getT() / Constants::deltaHeadingRad);
-    //      }
-
-    //      dubinsCost = dubinsLookup[uX * Constants::dubinsWidth * Constants::headings * Constants::headings
-    //                                + uY *  Constants::headings * Constants::headings
-    //                                + h0 * Constants::headings
-    //                                + h1];
-    //    } else {
-
-    /*if (Constants::dubinsShot && std::abs(start.getX() - goal.getX()) >= 10 && std::abs(start.getY() - goal.getY()) >= 10)*/
-    //      // start
-    //      double q0[] = { start.getX(), start.getY(), start.getT()};
-    //      // goal
-    //      double q1[] = { goal.getX(), goal.getY(), goal.getT()};
-    //      DubinsPath dubinsPath;
-    //      dubins_init(q0, q1, Constants::r, &dubinsPath);
-    //      dubinsCost = dubins_path_length(&dubinsPath);
-
-    ompl::base::DubinsStateSpace dubinsPath(Constants::r);
-    State* dbStart = (State*)dubinsPath.allocState();
-    State* dbEnd = (State*)dubinsPath.allocState();
-    dbStart->setXY(start.getX(), start.getY());
-    dbStart->setYaw(start.getT());
-    dbEnd->setXY(goal.getX(), goal.getY());
-    dbEnd->setYaw(goal.getT());
-    dubinsCost = dubinsPath.distance(dbStart, dbEnd);
+    // use the lookup if it has been built and the start is within its area around the goal
+    if (!Constants::dubinsLookup || !dubinsLookup ||
+        !Lookup::dubinsCost(dubinsLookup, start.getX(), start.getY(), start.getT(), goal.getX(), goal.getY(), goal.getT(), dubinsCost)) {
+      dubinsCost = Heuristic::dubinsCost(start.getX(), start.getY(), start.getT(), goal.getX(), goal.getY(), goal.getT());
+    }
   }
 
   // if reversing is active use a
   if (Constants::reverse && !Constants::dubins) {
-    ros::Time t0 = ros::Time::now();
-    ompl::base::ReedsSheppStateSpace reedsSheppPath(Constants::r);
-    State* rsStart = (State*)reedsSheppPath.allocState();
-    State* rsEnd = (State*)reedsSheppPath.allocState();
-    rsStart->setXY(start.getX(), start.getY());
-    rsStart->setYaw(start.getT());
-    rsEnd->setXY(goal.getX(), goal.getY());
-    rsEnd->setYaw(goal.getT());
-    reedsSheppCost = reedsSheppPath.distance(rsStart, rsEnd);
-    //std::cout << "calculated Reed-Sheep Cost is: " << reedsSheppCost << std::endl;
-       ros::Time t1 = ros::Time::now();
-       ros::Duration d(t1 - t0);
-       //std::cout << "calculated Reed-Sheep Heuristic in ms: " << d * 1000 << std::endl;
+    reedsSheppCost = Heuristic::reedsSheppCost(start.getX(), start.getY(), start.getT(), goal.getX(), goal.getY(), goal.getT());
   }
 
   // if twoD heuristic is activated determine shortest path
   // unconstrained with obstacles
-  if (Constants::twoD && !nodes2D[(int)start.getY() * width + (int)start.getX()].isDiscovered()) {
-    ros::Time t0 = ros::Time::now();
+  if (Constants::twoD && !Constants::twoDField && !nodes2D[(int)start.getY() * width + (int)start.getX()].isDiscovered()) {
     // create a 2d start node
     Node2D start2d(start.getX(), start.getY(), 0, 0, nullptr);
     // create a 2d goal node
@@ -508,19 +664,19 @@ void updateH(Node3D& start, const Node3D& goal, Node2D* nodes2D, float* dubinsLo
     // run 2d astar and return the cost of the cheapest path for that node
     //std::cout << "created start and goal in 2d" << std::endl;
     //this is where series of pop2 come from!!!!!
-    nodes2D[(int)start.getY() * width + (int)start.getX()].setG(aStar(goal2d, start2d, nodes2D, width, height, configurationSpace));
-    ros::Time t1 = ros::Time::now();
-    ros::Duration d(t1 - t0);
-    std::cout << "calculated 2D Heuristic in ms: " << d * 1000 << std::endl;
+    nodes2D[(int)start.getY() * width + (int)start.getX()].setG(aStar(goal2d, start2d, nodes2D, context, width, height, configurationSpace));
+  }
+
+  // cells the field did not reach are unreachable from the goal, use the same large number as the 2D A*
+  if (Constants::twoDField && !nodes2D[(int)start.getY() * width + (int)start.getX()].isDiscovered()) {
+    nodes2D[(int)start.getY() * width + (int)start.getX()].setG(1000);
   }
 
   if (Constants::twoD) {
     // offset for same node in cell
     twoDoffset = sqrt(((start.getX() - (long)start.getX()) - (goal.getX() - (long)goal.getX())) * ((start.getX() - (long)start.getX()) - (goal.getX() - (long)goal.getX())) +
                       ((start.getY() - (long)start.getY()) - (goal.getY() - (long)goal.getY())) * ((start.getY() - (long)start.getY()) - (goal.getY() - (long)goal.getY())));
-    std::cout<<"twoDoffset: "<<twoDoffset<<std::endl;
     twoDCost = nodes2D[(int)start.getY() * width + (int)start.getX()].getG() - twoDoffset;
-    std::cout<<"twoDCost: "<<twoDCost<<std::endl;
 
     //std::cout << "offset for same node in cell"<< std::endl;
 
@@ -537,7 +693,8 @@ void updateH(Node3D& start, const Node3D& goal, Node2D* nodes2D, float* dubinsLo
 //###################################################
 //                                        DUBINS SHOT
 //###################################################
-Node3D* dubinsShot(Node3D& start, const Node3D& goal, CollisionDetection& configurationSpace) {
+Node3D* dubinsShot(Node3D& start, const Node3D& goal, SearchContext& context, CollisionDetection& configurationSpace) {
+  STATS_COUNT(dubinsShots);
   // start
   double q0[] = { start.getX(), start.getY(), start.getT() };
   // goal
@@ -547,43 +704,50 @@ Node3D* dubinsShot(Node3D& start, const Node3D& goal, CollisionDetection& config
   // calculate the path
   dubins_init(q0, q1, Constants::r, &path);
 
-  int i = 0;
-  float x = 0.f;
   float length = dubins_path_length(&path);
+  // the number of samples of the shot
+  int n = (int)std::ceil(length / Constants::dubinsStepSize);
+
+  if (n == 0) {
+    return nullptr;
+  }
 
-  Node3D* dubinsNodes = new Node3D [(int)(length / Constants::dubinsStepSize) + 1];
+  // the nodes of the shot, reused by the next shot as the path is traced before the next search
+  std::vector<Node3D>& dubinsNodes = context.dubinsNodes;
+  dubinsNodes.resize(n);
 
-  while (x <  length) {
+  // samples the path at the step i into the node
+  auto sample = [&](int i, Node3D & node) {
+    float x = i * Constants::dubinsStepSize;
     double q[3];
     dubins_path_sample(&path, x, q);
-    dubinsNodes[i].setX(q[0]);
-    dubinsNodes[i].setY(q[1]);
-    dubinsNodes[i].setT(Helper::normalizeHeadingRad(q[2]));
-
-    // collision check
-    if (configurationSpace.isTraversable(&dubinsNodes[i])) {
-
-      // set the predecessor to the previous step
-      if (i > 0) {
-        dubinsNodes[i].setPred(&dubinsNodes[i - 1]);
-      } else {
-        dubinsNodes[i].setPred(&start);
-      }
+    node.setX(q[0]);
+    node.setY(q[1]);
+    node.setT(Helper::normalizeHeadingRad(q[2]));
+    node.setG(start.getG() + x);
+  };
 
-      if (&dubinsNodes[i] == dubinsNodes[i].getPred()) {
-        std::cout << "looping shot";
-      }
+  // every coarse-th sample first, most shots collide and are rejected before the path is sampled densely
+  const int coarse = 64;
+  int m = 0;
 
-      x += Constants::dubinsStepSize;
-      i++;
-    } else {
-      std::cout << "Dubins shot collided, discarding the path" << "\n";
-      // delete all nodes
-      delete [] dubinsNodes;
-      return nullptr;
-    }
+  for (int i = 0; i < n; i += coarse) { sample(i, dubinsNodes[m++]); }
+
+  if (!configurationSpace.areTraversable(&dubinsNodes[0], m)) {
+    return nullptr;
+  }
+
+  for (int i = 0; i < n; ++i) {
+    sample(i, dubinsNodes[i]);
+    // set the predecessor to the previous step
+    dubinsNodes[i].setPred(i > 0 ? &dubinsNodes[i - 1] : &start);
+  }
+
+  // collision check of all samples at once
+  if (!configurationSpace.areTraversable(&dubinsNodes[0], n)) {
+    return nullptr;
   }
 
-  std::cout << "Dubins shot connected, returning the path" << "\n";
-  return &dubinsNodes[i - 1];
+  STATS_COUNT(dubinsShotsConnected);
+  return &dubinsNodes[n - 1];
 }
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <cstring>
+#include <memory>
 #include <ros/ros.h>
 #include <ros/package.h>
 #include <tf/transform_datatypes.h>
@@ -13,19 +14,21 @@
 #include "zdebug.h"
 #include "constants.h"
 #include "helper.h"
-#include "collisiondetection.h"
-#include "dynamicvoronoi.h"
-#include "algorithm.h"
+#include "clock.h"
 #include "node3d.h"
 #include "path.h"
-#include "smoother.h"
+#include "planner.h"
+#include "debugwriter.h"
 #include "visualize.h"
 #include "lookup.h"
+#include "parameters.h"
+#include "stats.h"
 #include "std_msgs/Int32.h"
 #include "geometry_msgs/Pose2D.h"
 #include "geometry_msgs/Vector3.h"
 #include "core_msgs/VehicleState.h"
 #include "core_msgs/MissionPark.h"
+#include "core_msgs/PlannerStats.h"
 #include "opencv2/opencv.hpp"
 #include <boost/thread.hpp>
 #include <boost/bind.hpp>
@@ -36,13 +39,17 @@ float map_resol;
 float wheelbase = 1.6;
 bool isparkmission = false;
 int map_width, map_height;
-int headings;
 float delay = 0.4;
 int flag_obstacle = 0;
 int target_x = 0;
 int target_y = 0;
 
 image_transport::Publisher publishMonintorMap;
+ros::Publisher publishStats;
+/// the CSV file the statistics of every plan are appended to, none if empty
+std::string stats_csv;
+/// writes the debug snapshots of the Voronoi diagram and the path off the planning thread
+std::unique_ptr<DebugWriter> debugWriter;
 sensor_msgs::ImagePtr msgMonitorMap;
 
 
@@ -53,24 +60,16 @@ class Astar
 public:
   Astar();
   void plan(geometry_msgs::PoseWithCovarianceStamped start, geometry_msgs::PoseStamped goal);
-  void initializeLookups();
   cv::Mat gridmap;
-  /// The path produced by the hybrid A* algorithm
-
-  /// The smoother used for optimizing the path
-  Smoother smoother;
+  /// The ROS independent planning pipeline
+  Planner planner;
   /// The path smoothed and ready for the controller
   Path smoothedPath = Path(true);
   /// The visualization used for search visualization
   // Visualize visualization;
 
-  /// The collission detection for testing specific configurations
-  CollisionDetection configurationSpace;
-  /// The voronoi diagram
-  DynamicVoronoi voronoiDiagram;
+  /// The path produced by the hybrid A* algorithm
   Path path;
-  Constants::config collisionLookup[Constants::headings * Constants::positions];
-  float* dubinsLookup = new float [Constants::headings * Constants::headings * Constants::dubinsWidth * Constants::dubinsWidth];
 };
 
 
@@ -79,18 +78,6 @@ Astar::Astar() {
 }
 
 void Astar::plan(geometry_msgs::PoseWithCovarianceStamped start, geometry_msgs::PoseStamped goal) {
-      // ___________________________
-
-      //TODO Getting Rid of grid in this whole library, replace it with pacakge!!!!!!
-      //!!!!!!!
-
-      int depth = headings;
-      int length = map_width * map_height * depth;
-      // define list pointers and initialize lists
-      std::cout<<"length is "<<length<<std::endl;
-      Node3D* nodes3D = new Node3D[length](); //200*200*12 = 480000
-      Node2D* nodes2D = new Node2D[map_width * map_height]();
-
       // ________________________
       // retrieving goal position
       //this is in image frame
@@ -126,29 +113,20 @@ void Astar::plan(geometry_msgs::PoseWithCovarianceStamped start, geometry_msgs::
       // CLEAR THE PATH
       path.clear();
       smoothedPath.clear();
-      // FIND THE PATH
-      Node3D* nSolution = Algorithm::hybridAStar(nStart, nGoal, nodes3D, nodes2D, map_width, map_height, configurationSpace, dubinsLookup);
-      std::cout<<"nSolution is solved" <<std::endl;
+      // FIND AND SMOOTH THE PATH
+      bool found = planner.plan(nStart, nGoal);
 
       //DEBUG
       ros::Time plan_t1 = ros::Time::now();
       ros::Duration d1(plan_t1 - plan_t0);
-      std::cout << "Planning Time in ms: " << d1 * 1000 << std::endl;
-
+      std::cout << "Planning and smoothing Time in ms: " << d1 * 1000 << std::endl;
 
-      if(nSolution==nullptr) std::cout<<"nSolution is Null Pointer" <<std::endl;
-      // TRACE THE PATH (update the path in the smoother object)
+      if(!found) std::cout<<"nSolution is Null Pointer" <<std::endl;
       else {
-        smoother.tracePath(nSolution);
-        // CREATE THE UPDATED PATH
-        path.updatePath(smoother.getPath());
-        // SMOOTH THE PATH
-        smoother.smoothPath(voronoiDiagram);
-        // CREATE THE UPDATED PATH
-        smoothedPath.updatePath(smoother.getPath());
-        ros::Time plan_t2 = ros::Time::now();
-        ros::Duration d2(plan_t2 - plan_t1);
-        std::cout << "Smoothing Time in ms: " << d2 * 1000 << std::endl;
+        std::cout << "Suboptimality bound: " << planner.getBound() << std::endl;
+        // CREATE THE UPDATED PATHS
+        path.updatePath(planner.getPath());
+        smoothedPath.updatePath(planner.getSmoothedPath());
 
         // _________________________________
         // PUBLISH THE RESULTS OF THE SEARCH
@@ -156,12 +134,6 @@ void Astar::plan(geometry_msgs::PoseWithCovarianceStamped start, geometry_msgs::
         path.publishPath();
         smoothedPath.publishPath();
       }
-      delete [] nodes3D;
-      delete [] nodes2D;
-}
-
-void Astar::initializeLookups() {
-  Lookup::collisionLookup(collisionLookup);
 }
 
 /// A pointer to the grid the planner runs on
@@ -194,15 +166,61 @@ void callbackTerminate(const std_msgs::Int32Ptr& record) {
   return;
 }
 
+/// The lateral and forward displacement in cells and the heading change of the vehicle driving for dt seconds with the current velocity and steering angle
+void egoMotion(float dt, float& x_shift, float& y_shift, float& yaw_shift) {
+  yaw_shift = (float)(vel*delta*dt)/wheelbase;
+
+  if(yaw_shift != 0) {
+    x_shift = (float)(wheelbase*(1-cos(yaw_shift))/delta)/map_resol;
+    y_shift = (float)(wheelbase*sin(yaw_shift)/delta)/map_resol;
+  }
+  else {
+    x_shift = 0;
+    y_shift = vel*dt/map_resol;
+  }
+}
+
+/// Publishes the statistics of the current plan and appends them to the CSV file, if the statistics are compiled in
+void publishPlannerStats(const ros::Time& stamp) {
+#ifdef ASTAR_PLANNER_STATS
+  const PlannerStats& stats = PlannerStats::current;
+  core_msgs::PlannerStats msg;
+  msg.header.stamp = stamp;
+  msg.searches = stats.searches;
+  msg.expansions = stats.expansions;
+  msg.pushes = stats.pushes;
+  msg.lazy_deletions = stats.lazyDeletions;
+  msg.pruned = stats.pruned;
+  msg.twod_searches = stats.twoDSearches;
+  msg.twod_expansions = stats.twoDExpansions;
+  msg.twod_pushes = stats.twoDPushes;
+  msg.heuristic_evaluations = stats.heuristicEvaluations;
+  msg.dubins_shots = stats.dubinsShots;
+  msg.dubins_shots_connected = stats.dubinsShotsConnected;
+  msg.collision_checks = stats.collisionChecks;
+  msg.smoother_iterations = stats.smootherIterations;
+  msg.path_length = stats.pathLength;
+  msg.path_cost = stats.pathCost;
+  msg.bound = stats.bound;
+  msg.voronoi_time = stats.voronoiTime;
+  msg.search_time = stats.searchTime;
+  msg.twod_time = stats.twoDTime;
+  msg.smoothing_time = stats.smoothingTime;
+  msg.total_time = stats.totalTime;
+  publishStats.publish(msg);
+
+  if (!stats_csv.empty()) stats.appendCsv(stats_csv.c_str());
+#endif
+}
+
 void callbackMain(const sensor_msgs::ImageConstPtr& msg_map, Astar& astar)
 {
   if(Z_DEBUG && flag_obstacle!=0)  std::cout << "------------------------------------------------------------------" << std::endl;
   if(flag_obstacle==0) return;
+  PlannerStats::current.reset();
   ros::Time map_time = msg_map->header.stamp; //the time when the map is recorded
   ros::Time t0 = ros::Time::now();
 
-  astar.initializeLookups();
-
   cv_bridge::CvImageConstPtr cv_ptr;
   try
   {
@@ -214,48 +232,14 @@ void callbackMain(const sensor_msgs::ImageConstPtr& msg_map, Astar& astar)
     return;
   }
 
-  float yaw_delta = (float)(vel*delta*delay)/wheelbase;
-
-  float x_delay_shift, y_delay_shift;
-  if(yaw_delta != 0) {
-    x_delay_shift = (float)(wheelbase*(1-cos(yaw_delta))/delta)/map_resol;
-    y_delay_shift = (float)(wheelbase*sin(yaw_delta)/delta)/map_resol;
-  }
-  else {
-    x_delay_shift = 0;
-    y_delay_shift = vel*delay/map_resol;
-  }
+  float yaw_delta, x_delay_shift, y_delay_shift;
+  egoMotion(delay, x_delay_shift, y_delay_shift, yaw_delta);
   astar.gridmap = cv_ptr->image.clone();
-  astar.configurationSpace.updateGrid(astar.gridmap);
-  //create array for Voronoi diagram
-  int height = msg_map->height;
-  int width = msg_map->width;
-  //std::cout<<"height and width of msg_map is "<<height<<", "<<width<<std::endl;
-  bool** binMap;
-  binMap = new bool*[width];
-
-  for (int x = 0; x < width; x++) { binMap[x] = new bool[height]; }
-
-  for (int x = 0; x < width; ++x) {
-    for (int y = 0; y < height; ++y) {
-      cv::Vec3b px_val = astar.gridmap.at<cv::Vec3b>(x,y);
-      //if(x == width/2 && y == height/2) std::cout<<"the red pix value of map center is "<<(int)px_val.val[0]<<std::endl;
-      binMap[x][y] = (int)px_val.val[0]==255 ? true : false;//val[2]: red
-    }
+
+  if (!astar.planner.updateMap(astar.gridmap)) {
+    ROS_ERROR("the map is too large for the planner, it is skipped");
+    return;
   }
-  //if(binMap[width/2][height/2]) std::cout<<"the center is red!!"<<std::endl;
-
-  astar.voronoiDiagram.initializeMap(width, height, binMap);
-  astar.voronoiDiagram.update();
-  std::string vorono_path = ros::package::getPath("astar_planner")+"/config/result.ppm";
-  const char* vorono_path_chr = vorono_path.c_str();
-  astar.voronoiDiagram.visualize(vorono_path_chr);
-  //free won't work, is it neccessary?
-  //free((char*)vorono_path_chr);
-  //DEBUG
-  ros::Time t1 = ros::Time::now();
-  ros::Duration d(t1 - t0);
-  //std::cout << "created Voronoi Diagram in ms: " << d * 1000 << std::endl;
 
   // assign the values to start from base_link
   geometry_msgs::PoseWithCovarianceStamped start;
@@ -282,11 +266,25 @@ void callbackMain(const sensor_msgs::ImageConstPtr& msg_map, Astar& astar)
 
   std::cout << "start and goal set properly!! " << std::endl;
 
+  // shift the previous path by the ego-motion since the previous map
+  if (Constants::incremental) {
+    static ros::Time previous_map_time = map_time;
+    float yaw_shift, x_shift, y_shift;
+    egoMotion((map_time - previous_map_time).toSec(), x_shift, y_shift, yaw_shift);
+    previous_map_time = map_time;
+    astar.planner.getReplanner().shift(Node3D(map_height - y_shift, map_width/2 - x_shift, Helper::normalizeHeadingRad(yaw_shift+M_PI), 0, 0, nullptr),
+                          Node3D(map_height, map_width/2, M_PI, 0, 0, nullptr));
+  }
+
   astar.plan(start, goal);
   drawMonitorMap(astar);
+  // the snapshot is only copied here, the writer renders and saves it on its own thread
+  debugWriter->write(astar.planner.getVoronoi(), astar.planner.getSmoothedPath());
   ros::Time t2 = ros::Time::now();
   ros::Duration d_final(t2 - t0);
   cout<<"the delay ground truth is: " <<d_final.toSec()<<" sec" <<endl;
+  STATS_ADD(totalTime, d_final.toSec() * 1000);
+  publishPlannerStats(map_time);
 
   delay = 0.4 * 0.4 + delay * 0.36 + d_final.toSec() * 0.24;
   cout<<"the delay for planning is: " <<delay<<" sec" <<endl;
@@ -305,23 +303,37 @@ void callbackTarget(const geometry_msgs::Vector3::ConstPtr & msg_target) {
 int main(int argc, char** argv) {
   std::string config_path = ros::package::getPath("map_generator");
 	cv::FileStorage params_config(config_path+"/config/system_config.yaml", cv::FileStorage::READ);
-  float car_width = params_config["Vehicle.width"];
-  float car_length = params_config["Vehicle.length"];
   map_width = params_config["Map.width"];
   map_height = params_config["Map.height"];
   std::cout<<"map_width and map_height are "<<map_width<<", "<<map_height<<std::endl;
   map_resol = params_config["Map.resolution"];
-  headings = params_config["Path.headings"];
+  // the footprint and heading resolution of the search, they size every lookup and have to be set before the first one is built
+  Parameters parameters;
+
+  if (!parameters.load(config_path+"/config/system_config.yaml") || !Parameters::set(parameters)) {
+    return 1;
+  }
   wheelbase = params_config["Vehicle.wheelbase"];
   ros::init(argc, argv, "astar_planner");
   ros::start();
+  // the planner measures its deadlines with the ROS time, so it follows simulated time as well
+  Clock::setSource([]() { return ros::Time::now().toSec(); });
+  // the configuration spaces share the collision lookup, it is only built if there is no file matching the current constants
+  Lookup::sharedCollisionLookup((ros::package::getPath("astar_planner")+"/config/collision_lookup.bin").c_str());
   Astar astar;
+  if (!params_config["Path.deadline"].empty()) astar.planner.deadline = (double)params_config["Path.deadline"];
+  if (!params_config["Path.stats_csv"].empty()) stats_csv = (std::string)params_config["Path.stats_csv"];
+  int debug_sampling = Constants::debugSampling;
+  if (!params_config["Path.debug_sampling"].empty()) debug_sampling = (int)params_config["Path.debug_sampling"];
+  debugWriter.reset(new DebugWriter(ros::package::getPath("astar_planner")+"/config/result.ppm", debug_sampling));
+  if (Constants::dubinsLookup) astar.planner.initializeDubinsLookup(ros::package::getPath("astar_planner")+"/config/dubins_lookup.bin");
   // /map publish를 위한 설정 (publishMap & msgMap)
   ros::NodeHandle nh;
   // this is for monitoring
   image_transport::ImageTransport it(nh);
   publishMonintorMap = it.advertise("/monitor_map",1);
   msgMonitorMap.reset(new sensor_msgs::Image);
+  publishStats = nh.advertise<core_msgs::PlannerStats>("/planner_stats",1);
 
   ros::Subscriber stateSub = nh.subscribe("/vehicle_state",1,callbackState);
   ros::Subscriber parkingSub = nh.subscribe("/mission_park",1,callbackPark);
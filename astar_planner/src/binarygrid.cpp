@@ -0,0 +1,48 @@
+#include "binarygrid.h"
+
+#include "opencv2/opencv.hpp"
+
+#include "parameters.h"
+
+using namespace HybridAStar;
+
+void BinaryGrid::update(const cv::Mat& gridmap) {
+  sizeX = gridmap.rows;
+  sizeY = gridmap.cols;
+  stride = (sizeY + wordBits - 1) / wordBits + 2;
+  padRows = Parameters::get().bbSize();
+  words.assign((sizeX + 2 * padRows) * stride, 0);
+
+  for (int x = 0; x < sizeX; ++x) {
+    const cv::Vec3b* pixels = gridmap.ptr<cv::Vec3b>(x);
+    uint64_t* cells = &words[(x + padRows) * stride + 1];
+
+    for (int y = 0; y < sizeY; ++y) {
+      cells[y / wordBits] |= (uint64_t)(pixels[y][0] == 255) << (y % wordBits);
+    }
+  }
+}
+
+bool BinaryGrid::changes(const BinaryGrid& previous, int limit, std::vector<Change>& changes) const {
+  changes.clear();
+
+  if (previous.sizeX != sizeX || previous.sizeY != sizeY || previous.padRows != padRows) { return false; }
+
+  for (int x = 0; x < sizeX; ++x) {
+    const uint64_t* now = row(x);
+    const uint64_t* before = previous.row(x);
+
+    for (int w = 1; w < stride - 1; ++w) {
+      // every set bit of the difference is a changed cell
+      for (uint64_t diff = now[w] ^ before[w]; diff; diff &= diff - 1) {
+        if ((int)changes.size() == limit) { return false; }
+
+        int bit = __builtin_ctzll(diff);
+        Change change = {x, (w - 1) * wordBits + bit, (now[w] >> bit & 1) != 0};
+        changes.push_back(change);
+      }
+    }
+  }
+
+  return true;
+}
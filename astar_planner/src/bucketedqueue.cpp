@@ -6,75 +6,110 @@
 
 using namespace HybridAStar;
 
-std::vector<int> BucketPrioQueue::sqrIndices;
-int BucketPrioQueue::numBuckets;
-
-
 BucketPrioQueue::BucketPrioQueue() {
-  // make sure the index array is created
-  if (sqrIndices.size()==0) initSqrIndices();
+  sizeX = 0;
+  sizeY = 0;
+  count = 0;
   nextBucket = INT_MAX;
-    
-  // now create the buckets
-  //    buckets = std::vector<MyQueue2<INTPOINT> >(numBuckets);
-  buckets = std::vector<std::queue<INTPOINT> >(numBuckets);
+  freeBlocks = -1;
+}
 
-  // reset element counter 
+void BucketPrioQueue::resize(int _sizeX, int _sizeY) {
+  // an empty queue of the same size is ready to use
+  if (_sizeX==sizeX && _sizeY==sizeY && count==0) return;
+
+  Bucket empty = {-1, -1, 0, 0};
+
+  // the buckets only change with the size of the map
+  if (_sizeX!=sizeX || _sizeY!=sizeY) {
+    sizeX = _sizeX;
+    sizeY = _sizeY;
+    int maxX = sizeX>0 ? sizeX-1 : 0;
+    int maxY = sizeY>0 ? sizeY-1 : 0;
+    sqrIndices.assign(maxX*maxX + maxY*maxY + 1, -1);
+
+    for (int x=0; x<=maxX; x++) {
+      for (int y=0; y<=maxY; y++) sqrIndices[x*x+y*y] = 0;
+    }
+
+    // number the sums of two squares in increasing order, so the buckets are popped in the order of their distances
+    int numBuckets = 0;
+    for (unsigned int sqr=0; sqr<sqrIndices.size(); sqr++) {
+      if (sqrIndices[sqr]==0) sqrIndices[sqr] = numBuckets++;
+    }
+
+    buckets.assign(numBuckets, empty);
+    nonEmpty.assign((numBuckets+63)/64, 0);
+  } else {
+    buckets.assign(buckets.size(), empty);
+    nonEmpty.assign(nonEmpty.size(), 0);
+  }
+
+  // every block of the pool is free again
+  freeBlocks = -1;
+  for (int i=(int)blocks.size()-1; i>=0; i--) freeBlock(i);
   count = 0;
+  nextBucket = INT_MAX;
 }
 
-bool BucketPrioQueue::empty() {
-  return (count==0);
-}
+int BucketPrioQueue::allocateBlock() {
+  if (freeBlocks<0) {
+    blocks.push_back(Block());
+    return blocks.size()-1;
+  }
 
+  int block = freeBlocks;
+  freeBlocks = blocks[block].next;
+  return block;
+}
 
 void BucketPrioQueue::push(int prio, INTPOINT t) {
-  if (prio>=(int)sqrIndices.size()) {
-    fprintf(stderr, "error: priority %d is not a valid squared distance x*x+y*y, or x>MAXDIST or y>MAXDIST.\n", prio);
-    exit(-1);
-  }
-  int id = sqrIndices[prio];
+  int id = prio>=0 && prio<(int)sqrIndices.size() ? sqrIndices[prio] : -1;
   if (id<0) {
-    fprintf(stderr, "error: priority %d is not a valid squared distance x*x+y*y, or x>MAXDIST or y>MAXDIST.\n", prio);
+    fprintf(stderr, "error: priority %d is not a valid squared distance x*x+y*y within a map of %d x %d cells.\n", prio, sizeX, sizeY);
     exit(-1);
   }
-  buckets[id].push(t);
-  //    printf("pushing %d with prio %d into %d. Next: %d\n", t.x, prio, id, nextBucket);
+
+  Bucket& b = buckets[id];
+  if (b.tail<0) {
+    b.head = b.tail = allocateBlock();
+    b.headPos = b.tailPos = 0;
+    nonEmpty[id/64] |= (uint64_t)1 << (id%64);
+  } else if (b.tailPos==blockSize) {
+    int block = allocateBlock();
+    blocks[b.tail].next = block;
+    b.tail = block;
+    b.tailPos = 0;
+  }
+  blocks[b.tail].points[b.tailPos++] = t;
+
   if (id<nextBucket) nextBucket = id;
-  //    printf("push new next is %d\n", nextBucket);
   count++;
 }
 
 INTPOINT BucketPrioQueue::pop() {
-  int i;
   assert(count>0);
-  //    printf("next: %d\n", nextBucket);
-  for (i = nextBucket; i<(int)buckets.size(); i++) {
-    if (!buckets[i].empty()) break;	
-  }
-  assert(i<(int)buckets.size());
+  // the first non-empty bucket from the next one on
+  int w = nextBucket/64;
+  uint64_t bits = nonEmpty[w] & (~(uint64_t)0 << (nextBucket%64));
+  while (!bits) bits = nonEmpty[++w];
+  int i = w*64 + __builtin_ctzll(bits);
   nextBucket = i;
-  //    printf("pop new next %d\n", nextBucket);
   count--;
-  INTPOINT p = buckets[i].front();
-  buckets[i].pop();
-  return p;
-}
-
 
-void BucketPrioQueue::initSqrIndices() {
-  //    std::cout << "BUCKETQUEUE Starting to build the index array...\n";
-  //  std::set<int> sqrNumbers;
+  Bucket& b = buckets[i];
+  INTPOINT p = blocks[b.head].points[b.headPos++];
 
-  sqrIndices = std::vector<int>(2*MAXDIST*MAXDIST+1, -1);
-
-  int count=0;
-  for (int x=0; x<=MAXDIST; x++) {
-    for (int y=0; y<=x; y++) {
-      int sqr = x*x+y*y;
-      sqrIndices[sqr] = count++;
-    }
+  if (b.head==b.tail && b.headPos==b.tailPos) {
+    // the bucket is empty
+    freeBlock(b.head);
+    b.head = b.tail = -1;
+    nonEmpty[w] &= ~((uint64_t)1 << (i%64));
+  } else if (b.headPos==blockSize) {
+    int next = blocks[b.head].next;
+    freeBlock(b.head);
+    b.head = next;
+    b.headPos = 0;
   }
-  numBuckets = count;
-  //    std::cout << "BUCKETQUEUE Done with building the index arrays.\n";
+  return p;
 }
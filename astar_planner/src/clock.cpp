@@ -0,0 +1,11 @@
+#include "clock.h"
+
+#include <chrono>
+
+using namespace HybridAStar;
+
+Clock::Source Clock::source = Clock::steady;
+
+double Clock::steady() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
@@ -2,8 +2,76 @@
 
 using namespace HybridAStar;
 
-CollisionDetection::CollisionDetection() {
-  Lookup::collisionLookup(collisionLookup);
+CollisionDetection::CollisionDetection() :
+  collisionLookup(Lookup::sharedCollisionLookup()),
+  headings(Parameters::get().headings),
+  sweptVolume(Constants::sweptCollision ? &SweptVolume::shared() : nullptr),
+  footprints(headings * Constants::positions),
+  circles(headings * Constants::positions) {
+  // pack the cells of every footprint into a bit mask per row, relative to the corner of its bounding box
+  for (int i = 0; i < headings * Constants::positions; ++i) {
+    const Constants::config& config = collisionLookup[i];
+    Footprint& footprint = footprints[i];
+    int maxX = 0, maxY = 0;
+    footprint.x = footprint.y = 0;
+
+    for (int j = 0; j < config.length; ++j) {
+      if (j == 0 || config.pos[j].x < footprint.x) { footprint.x = config.pos[j].x; }
+
+      if (j == 0 || config.pos[j].y < footprint.y) { footprint.y = config.pos[j].y; }
+
+      if (j == 0 || config.pos[j].x > maxX) { maxX = config.pos[j].x; }
+
+      if (j == 0 || config.pos[j].y > maxY) { maxY = config.pos[j].y; }
+    }
+
+    footprint.rows = config.length ? maxX - footprint.x + 1 : 0;
+
+    if (maxY - footprint.y >= BinaryGrid::wordBits) {
+      footprint.rows = -1;
+      continue;
+    }
+    footprint.offset = footprintMasks.size();
+    footprintMasks.resize(footprintMasks.size() + footprint.rows, 0);
+
+    for (int j = 0; j < config.length; ++j) {
+      footprintMasks[footprint.offset + config.pos[j].x - footprint.x] |= (uint64_t)1 << (config.pos[j].y - footprint.y);
+    }
+  }
+
+  // cover the rectangle with circles of equal parts of its length
+  const float length = Parameters::get().length / Constants::cellSize;
+  const float width = Parameters::get().width / Constants::cellSize;
+  const float part = length / Constants::circles;
+
+  // the distance map measures between cell centers, a point and an obstacle cell can be up to sqrt(2) closer,
+  // the traversal of the lookup may mark one more cell at the corners
+  circleRadius = std::sqrt(part * part / 4 + width * width / 4) + std::sqrt(2.f) + 1;
+  innerRadius = width / 2 - std::sqrt(2.f);
+
+  // the cells of the centers of the circles for every configuration of the lookup, relative to the cell of the configuration
+  const double center = (double)Parameters::get().bbSize() / 2;
+
+  for (int iY = 0; iY < Constants::positionResolution; ++iY) {
+    for (int iX = 0; iX < Constants::positionResolution; ++iX) {
+      // the center of the footprint in the lookup, which is placed at a discrete position within the cell and rasterized
+      double cX = center + (float)iX / Constants::positionResolution - (int)(center + (float)iX / Constants::positionResolution);
+      double cY = center + (float)iY / Constants::positionResolution - (int)(center + (float)iY / Constants::positionResolution);
+
+      for (int iT = 0; iT < headings; ++iT) {
+        Circles& cells = circles[(iY * Constants::positionResolution + iX) * headings + iT];
+        double t = iT * Parameters::get().deltaHeadingRad();
+        cells.x[0] = (int)std::floor(cX);
+        cells.y[0] = (int)std::floor(cY);
+
+        for (int i = 0; i < Constants::circles; ++i) {
+          float offset = -length / 2 + part * (i + 0.5f);
+          cells.x[i + 1] = (int)std::floor(cX + offset * std::cos(t));
+          cells.y[i + 1] = (int)std::floor(cY + offset * std::sin(t));
+        }
+      }
+    }
+  }
 }
 
 //template<typename T> bool CollisionDetection::isTraversable(const T* node) {
@@ -28,27 +96,123 @@ CollisionDetection::CollisionDetection() {
 //}
 
 bool CollisionDetection::configurationTest(float x, float y, float t) {
-  //std::cout<<"configurationTest starts"<<std::endl;
-  int X = (int)x;
-  int Y = (int)y;
-  int iX = (int)((x - (long)x) * Constants::positionResolution);
-  iX = iX > 0 ? iX : 0;
-  int iY = (int)((y - (long)y) * Constants::positionResolution);
-  iY = iY > 0 ? iY : 0;
-  int iT = (int)(t / Constants::deltaHeadingRad);
-  int idx = iY * Constants::positionResolution * Constants::headings + iX * Constants::headings + iT;
-  int cX;
-  int cY;
-  //std::cout<<"configurationTest constants set"<<std::endl;
+  return configurationTest(key(x, y, t));
+}
+
+bool CollisionDetection::configurationTest(const Key& key) {
+  const int X = key.X;
+  const int Y = key.Y;
+  const int idx = key.idx;
+
+  // the dilated grid answers with a single bit on the map
+  if (Constants::headingLayers && layers_.contains(X, Y)) { return !layers_.isBlocked(X, Y, idx % headings); }
+
+  if (Constants::circleCollision && voronoi_) {
+    CircleTest result = circleTest(X, Y, idx);
+
+    if (result != circlesUnknown) { return result == circlesFree; }
+  }
+
+  const Footprint& footprint = footprints[idx];
+  int cX = X + footprint.x;
+  int cY = Y + footprint.y;
+
+  // test the rows of the footprint word-wide, cells beyond the map are free
+  if (footprint.rows >= 0 && grid_.isPadded(cX, cY) && grid_.isPadded(cX + footprint.rows - 1, cY)) {
+    const uint64_t* masks = &footprintMasks[footprint.offset];
+
+    for (int r = 0; r < footprint.rows; ++r) {
+      if (grid_.cells(cX + r, cY) & masks[r]) { return false; }
+    }
+
+    return true;
+  }
+
+  // far beyond the map or wider than a word test cell by cell
   for (int i = 0; i < collisionLookup[idx].length; ++i) {
     cX = (X + collisionLookup[idx].pos[i].x);
     cY = (Y + collisionLookup[idx].pos[i].y);
 
-    // make sure the configuration coordinates are actually on the grid
-    if (cX >= 0 && (unsigned int)cX < gridmap_.size().width && cY >= 0 && (unsigned int)cY < gridmap_.size().height) {
-      //if((int)gridmap_.at<cv::Vec3b>(cX,cY).val[0]==255) std::cout<<"red"<<std::endl;
-      if ((int)gridmap_.at<cv::Vec3b>(cX,cY).val[0]==255) {
-        //std::cout<<"false will be returned in the for loop"<<std::endl;
+    if (grid_.isOccupied(cX, cY)) { return false; }
+  }
+
+  return true;
+}
+
+//###################################################
+//                                            BATCHES
+//###################################################
+int CollisionDetection::traversableMask(const Node3D* nodes, int n, uint8_t* traversable) {
+  keys.resize(n);
+
+  for (int i = 0; i < n; ++i) { keys[i] = key(nodes[i].getX(), nodes[i].getY(), nodes[i].getT()); }
+
+  int count = 0;
+
+  for (int i = 0; i < n; ++i) {
+    // consecutive configurations of the same cell, position and heading share their test
+    if (i > 0 && keys[i] == keys[i - 1]) {
+      traversable[i] = traversable[i - 1];
+    } else {
+      STATS_COUNT(collisionChecks);
+      traversable[i] = configurationTest(keys[i]);
+    }
+
+    count += traversable[i];
+  }
+
+  return count;
+}
+
+bool CollisionDetection::areTraversable(const Node3D* nodes, int n) {
+  keys.resize(n);
+  int m = 0;
+
+  // the distinct configurations of the lookup, consecutive samples of a path mostly fall into the same one
+  for (int i = 0; i < n; ++i) {
+    Key k = key(nodes[i].getX(), nodes[i].getY(), nodes[i].getT());
+
+    if (m == 0 || !(k == keys[m - 1])) { keys[m++] = k; }
+  }
+
+  for (int i = 0; i < m; ++i) {
+    STATS_COUNT(collisionChecks);
+
+    if (!configurationTest(keys[i])) { return false; }
+  }
+
+  return true;
+}
+
+bool CollisionDetection::isTraversable(const Node3D* pred, int i) const {
+  if (!sweptVolume) { return true; }
+
+  float x = pred->getX();
+  float y = pred->getY();
+  int X = (int)x;
+  int Y = (int)y;
+  const SweptVolume::Mask& mask = sweptVolume->get(x, y, Primitives::bin(pred->getT()), i);
+  const uint64_t* rows = sweptVolume->getRows(mask);
+  int cX = X + mask.x;
+  int cY = Y + mask.y;
+
+  const int lastY = cY + (mask.words - 1) * BinaryGrid::wordBits;
+
+  // test the rows of the swept cells word-wide, stopping at the first obstacle
+  if (grid_.isPadded(cX, cY) && grid_.isPadded(cX + mask.rows - 1, lastY)) {
+    for (int r = 0; r < mask.rows; ++r) {
+      for (int w = 0; w < mask.words; ++w) {
+        if (grid_.cells(cX + r, cY + w * BinaryGrid::wordBits) & rows[r * mask.words + w]) { return false; }
+      }
+    }
+
+    return true;
+  }
+
+  // far beyond the map test cell by cell
+  for (int r = 0; r < mask.rows; ++r) {
+    for (int c = 0; c < mask.words * BinaryGrid::wordBits; ++c) {
+      if ((rows[r * mask.words + c / BinaryGrid::wordBits] >> (c % BinaryGrid::wordBits)) & 1 && grid_.isOccupied(cX + r, cY + c)) {
         return false;
       }
     }
@@ -56,3 +220,26 @@ bool CollisionDetection::configurationTest(float x, float y, float t) {
 
   return true;
 }
+
+CollisionDetection::CircleTest CollisionDetection::circleTest(int X, int Y, int idx) const {
+  const Circles& cells = circles[idx];
+  const int sizeX = voronoi_->getSizeX();
+  const int sizeY = voronoi_->getSizeY();
+
+  for (int i = 0; i <= Constants::circles; ++i) {
+    int cX = X + cells.x[i];
+    int cY = Y + cells.y[i];
+
+    // the diagram does not maintain the distances of the border cells, there and beyond the footprint decides
+    if (cX <= 0 || cX >= sizeX - 1 || cY <= 0 || cY >= sizeY - 1) { return circlesUnknown; }
+
+    float distance = voronoi_->getCell(cX, cY).dist;
+
+    // an obstacle in the inscribed circle is within the footprint
+    if (i == 0 && distance <= innerRadius) { return circlesBlocked; }
+
+    if (i > 0 && distance <= circleRadius) { return circlesUnknown; }
+  }
+
+  return circlesFree;
+}
@@ -0,0 +1,141 @@
+#include "debugwriter.h"
+
+#include <cstdio>
+#include <iostream>
+
+using namespace HybridAStar;
+
+DebugWriter::DebugWriter(const std::string& file, int sampling, int capacity) :
+  file(file), sampling(sampling), capacity(capacity) {
+  if (sampling > 0 && capacity > 0) { thread = std::thread(&DebugWriter::run, this); }
+}
+
+DebugWriter::~DebugWriter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+  }
+  wake.notify_one();
+
+  if (thread.joinable()) { thread.join(); }
+}
+
+//###################################################
+//                                           SNAPSHOT
+//###################################################
+bool DebugWriter::write(DynamicVoronoi& voronoi, const std::vector<Node3D>& path) {
+  if (!thread.joinable() || maps++ % sampling != 0) { return false; }
+
+  Snapshot snapshot;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if ((int)queue.size() >= capacity) {
+      ++dropped;
+      return false;
+    }
+
+    if (!spare.empty()) {
+      snapshot = std::move(spare.back());
+      spare.pop_back();
+    }
+  }
+
+  // only the copy runs on the thread of the planner, the arrays of a recycled snapshot keep their memory
+  snapshot.sizeX = voronoi.getSizeX();
+  snapshot.sizeY = voronoi.getSizeY();
+  snapshot.dist.resize(snapshot.sizeX * snapshot.sizeY);
+  snapshot.state.resize(snapshot.sizeX * snapshot.sizeY);
+  snapshot.path.clear();
+
+  for (int x = 0; x < snapshot.sizeX; ++x) {
+    for (int y = 0; y < snapshot.sizeY; ++y) {
+      const DynamicVoronoi::dataCell& c = voronoi.cell(x, y);
+      snapshot.dist[x * snapshot.sizeY + y] = c.dist;
+      // the obstacles come from the binary map, a lazy map only knows the distances of the cells queried
+      snapshot.state[x * snapshot.sizeY + y] = voronoi.isVoronoi(x, y) ? voronoiCell : c.sqdist == 0 || voronoi.gridCell(x, y) ? obstacleCell : freeCell;
+    }
+  }
+
+  for (const Node3D& node : path) { snapshot.path.push_back(INTPOINT((int)node.getX(), (int)node.getY())); }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    queue.push_back(std::move(snapshot));
+  }
+  wake.notify_one();
+  return true;
+}
+
+//###################################################
+//                                             WRITER
+//###################################################
+void DebugWriter::run() {
+  std::unique_lock<std::mutex> lock(mutex);
+
+  while (true) {
+    wake.wait(lock, [this]() { return stop || !queue.empty(); });
+
+    if (queue.empty()) { return; }
+
+    Snapshot snapshot = std::move(queue.front());
+    queue.pop_front();
+    lock.unlock();
+    save(snapshot);
+    lock.lock();
+    spare.push_back(std::move(snapshot));
+  }
+}
+
+void DebugWriter::save(const Snapshot& snapshot) const {
+  const int sizeX = snapshot.sizeX;
+  const int sizeY = snapshot.sizeY;
+  // the image of DynamicVoronoi::visualize, x to the right and y up
+  std::vector<unsigned char> pixels(3 * sizeX * sizeY);
+
+  for (int x = 0; x < sizeX; ++x) {
+    for (int y = 0; y < sizeY; ++y) {
+      unsigned char* pixel = &pixels[3 * ((sizeY - 1 - y) * sizeX + x)];
+      int i = x * sizeY + y;
+
+      if (snapshot.state[i] == voronoiCell) {
+        pixel[0] = 255;
+        pixel[1] = 0;
+        pixel[2] = 0;
+      } else if (snapshot.state[i] == obstacleCell) {
+        pixel[0] = pixel[1] = pixel[2] = 0;
+      } else {
+        float f = 80 + snapshot.dist[i] * 5;
+        if (f > 255) { f = 255; }
+        if (f < 0) { f = 0; }
+        pixel[0] = pixel[1] = pixel[2] = (unsigned char)f;
+      }
+    }
+  }
+
+  for (const INTPOINT& p : snapshot.path) {
+    if (p.x < 0 || p.x >= sizeX || p.y < 0 || p.y >= sizeY) { continue; }
+
+    unsigned char* pixel = &pixels[3 * ((sizeY - 1 - p.y) * sizeX + p.x)];
+    pixel[0] = 0;
+    pixel[1] = 255;
+    pixel[2] = 0;
+  }
+
+  std::string temporary = file + ".tmp";
+  FILE* F = fopen(temporary.c_str(), "wb");
+
+  if (!F) {
+    std::cerr << "could not open " << temporary << " for the debug output" << std::endl;
+    return;
+  }
+
+  fprintf(F, "P6\n%d %d 255\n", sizeX, sizeY);
+  fwrite(pixels.data(), 1, pixels.size(), F);
+  fclose(F);
+
+  if (std::rename(temporary.c_str(), file.c_str()) != 0) {
+    std::cerr << "could not replace " << file << " with the debug output" << std::endl;
+  }
+}
@@ -7,39 +7,29 @@ using namespace HybridAStar;
 
 DynamicVoronoi::DynamicVoronoi() {
   sqrt2 = sqrt(2.0);
-  data = NULL;
-  gridMap = NULL;
+  sizeX = 0;
+  sizeY = 0;
+  lazy = false;
 }
 
-DynamicVoronoi::~DynamicVoronoi() {
-  if (data) {
-    for (int x=0; x<sizeX; x++) delete[] data[x];
-    delete[] data;
+bool DynamicVoronoi::initializeEmpty(int _sizeX, int _sizeY, bool initGridMap) {
+  // the coordinates of the closest obstacles are shorts, a larger map would truncate them
+  if (_sizeX >= invalidObstData || _sizeY >= invalidObstData) {
+    std::cerr << "the map " << _sizeX << " x " << _sizeY << " is too large for the diagram, at most "
+              << invalidObstData - 1 << " cells per side are supported" << std::endl;
+    sizeX = 0;
+    sizeY = 0;
+    lazy = false;
+    open.resize(0, 0);
+    data.clear();
+    gridMap.clear();
+    return false;
   }
-  if (gridMap) {
-    for (int x=0; x<sizeX; x++) delete[] gridMap[x];
-    delete[] gridMap;
-  }
-}
 
-void DynamicVoronoi::initializeEmpty(int _sizeX, int _sizeY, bool initGridMap) {
   sizeX = _sizeX;
   sizeY = _sizeY;
-  if (data) {
-    for (int x=0; x<sizeX; x++) delete[] data[x];
-    delete[] data;
-  }
-  data = new dataCell*[sizeX];
-  for (int x=0; x<sizeX; x++) data[x] = new dataCell[sizeY];
-
-  if (initGridMap) {
-    if (gridMap) {
-      for (int x=0; x<sizeX; x++) delete[] gridMap[x];
-      delete[] gridMap;
-    }
-    gridMap = new bool*[sizeX];
-    for (int x=0; x<sizeX; x++) gridMap[x] = new bool[sizeY];
-  }
+  lazy = false;
+  open.resize(sizeX, sizeY);
 
   dataCell c;
   c.dist = INFINITY;
@@ -50,23 +40,55 @@ void DynamicVoronoi::initializeEmpty(int _sizeX, int _sizeY, bool initGridMap) {
   c.queueing = fwNotQueued;
   c.needsRaise = false;
 
-  for (int x=0; x<sizeX; x++)
-    for (int y=0; y<sizeY; y++) data[x][y] = c;
+  // the arrays keep their memory between maps of the same size
+  data.assign(sizeX*sizeY, c);
+
+  if (initGridMap) gridMap.assign(sizeX*sizeY, 0);
+  return true;
+}
+
+bool DynamicVoronoi::initializeMap(const BinaryGrid& grid) {
+  if (!initializeEmpty(grid.getSizeX(), grid.getSizeY(), true)) return false;
+
+  for (int x=0; x<sizeX; x++) {
+    for (int y=0; y<sizeY; y++) gridCell(x,y) = grid.isOccupied(x,y);
+  }
+
+  initializeObstacles();
+  return true;
+}
+
+bool DynamicVoronoi::initializeLazy(const BinaryGrid& grid, ThreadPool& pool) {
+  if (!initializeEmpty(grid.getSizeX(), grid.getSizeY(), true)) return false;
 
-  if (initGridMap) {
-    for (int x=0; x<sizeX; x++)
-      for (int y=0; y<sizeY; y++) gridMap[x][y] = 0;
+  for (int x=0; x<sizeX; x++) {
+    for (int y=0; y<sizeY; y++) gridCell(x,y) = grid.isOccupied(x,y);
   }
+
+  // there is no diagram, only the distances of the cells queried
+  for (unsigned int i=0; i<data.size(); i++) data[i].voronoi = occupied;
+
+  updateRowDist(pool);
+  lazy = true;
+  return true;
 }
 
-void DynamicVoronoi::initializeMap(int _sizeX, int _sizeY, bool** _gridMap) {
-  gridMap = _gridMap;
-  initializeEmpty(_sizeX, _sizeY, false);
+bool DynamicVoronoi::initializeMap(int _sizeX, int _sizeY, bool** _gridMap) {
+  if (!initializeEmpty(_sizeX, _sizeY, true)) return false;
 
+  for (int x=0; x<sizeX; x++) {
+    for (int y=0; y<sizeY; y++) gridCell(x,y) = _gridMap[x][y];
+  }
+
+  initializeObstacles();
+  return true;
+}
+
+void DynamicVoronoi::initializeObstacles() {
   for (int x=0; x<sizeX; x++) {
     for (int y=0; y<sizeY; y++) {
-      if (gridMap[x][y]) {
-        dataCell c = data[x][y];
+      if (gridCell(x,y)) {
+        dataCell c = cell(x,y);
         if (!isOccupied(x,y,c)) {
 
           bool isSurrounded = true;
@@ -78,7 +100,7 @@ void DynamicVoronoi::initializeMap(int _sizeX, int _sizeY, bool** _gridMap) {
               int ny = y+dy;
               if (ny<=0 || ny>=sizeY-1) continue;
 
-              if (!gridMap[nx][ny]) {
+              if (!gridCell(nx,ny)) {
                 isSurrounded = false;
                 break;
               }
@@ -91,7 +113,7 @@ void DynamicVoronoi::initializeMap(int _sizeX, int _sizeY, bool** _gridMap) {
             c.dist=0;
             c.voronoi=occupied;
             c.queueing = fwProcessed;
-            data[x][y] = c;
+            cell(x,y) = c;
           } else setObstacle(x,y);
         }
       }
@@ -100,33 +122,33 @@ void DynamicVoronoi::initializeMap(int _sizeX, int _sizeY, bool** _gridMap) {
 }
 
 void DynamicVoronoi::occupyCell(int x, int y) {
-  gridMap[x][y] = 1;
+  gridCell(x,y) = 1;
   setObstacle(x,y);
 }
 void DynamicVoronoi::clearCell(int x, int y) {
-  gridMap[x][y] = 0;
+  gridCell(x,y) = 0;
   removeObstacle(x,y);
 }
 
 void DynamicVoronoi::setObstacle(int x, int y) {
-  dataCell c = data[x][y];
+  dataCell c = cell(x,y);
   if(isOccupied(x,y,c)) return;
 
   addList.push_back(INTPOINT(x,y));
   c.obstX = x;
   c.obstY = y;
-  data[x][y] = c;
+  cell(x,y) = c;
 }
 
 void DynamicVoronoi::removeObstacle(int x, int y) {
-  dataCell c = data[x][y];
+  dataCell c = cell(x,y);
   if(isOccupied(x,y,c) == false) return;
 
   removeList.push_back(INTPOINT(x,y));
   c.obstX = invalidObstData;
   c.obstY  = invalidObstData;
   c.queueing = bwQueued;
-  data[x][y] = c;
+  cell(x,y) = c;
 }
 
 void DynamicVoronoi::exchangeObstacles(std::vector<INTPOINT> points) {
@@ -135,7 +157,7 @@ void DynamicVoronoi::exchangeObstacles(std::vector<INTPOINT> points) {
     int x = lastObstacles[i].x;
     int y = lastObstacles[i].y;
 
-    bool v = gridMap[x][y];
+    bool v = gridCell(x,y);
     if (v) continue;
     removeObstacle(x,y);
   }
@@ -145,7 +167,7 @@ void DynamicVoronoi::exchangeObstacles(std::vector<INTPOINT> points) {
   for (unsigned int i=0; i<points.size(); i++) {
     int x = points[i].x;
     int y = points[i].y;
-    bool v = gridMap[x][y];
+    bool v = gridCell(x,y);
     if (v) continue;
     setObstacle(x,y);
     lastObstacles.push_back(points[i]);
@@ -160,7 +182,7 @@ void DynamicVoronoi::update(bool updateRealDist) {
     INTPOINT p = open.pop();
     int x = p.x;
     int y = p.y;
-    dataCell c = data[x][y];
+    dataCell c = cell(x,y);
 
     if(c.queueing==fwProcessed) continue;
 
@@ -168,14 +190,17 @@ void DynamicVoronoi::update(bool updateRealDist) {
       // RAISE
       for (int dx=-1; dx<=1; dx++) {
         int nx = x+dx;
-        if (nx<=0 || nx>=sizeX-1) continue;
+        if (nx<0 || nx>=sizeX) continue;
         for (int dy=-1; dy<=1; dy++) {
           if (dx==0 && dy==0) continue;
           int ny = y+dy;
-          if (ny<=0 || ny>=sizeY-1) continue;
-          dataCell nc = data[nx][ny];
+          if (ny<0 || ny>=sizeY) continue;
+          dataCell nc = cell(nx,ny);
+          // the border is never lowered, only its obstacles are queued again to refill the raised cells
+          bool border = nx==0 || nx==sizeX-1 || ny==0 || ny==sizeY-1;
+          if (border && (nc.obstX!=nx || nc.obstY!=ny)) continue;
           if (nc.obstX!=invalidObstData && !nc.needsRaise) {
-            if(!isOccupied(nc.obstX,nc.obstY,data[nc.obstX][nc.obstY])) {
+            if(!isOccupied(nc.obstX,nc.obstY,cell(nc.obstX,nc.obstY))) {
               open.push(nc.sqdist, INTPOINT(nx,ny));
               nc.queueing = fwQueued;
               nc.needsRaise = true;
@@ -183,12 +208,12 @@ void DynamicVoronoi::update(bool updateRealDist) {
               nc.obstY = invalidObstData;
               if (updateRealDist) nc.dist = INFINITY;
               nc.sqdist = INT_MAX;
-              data[nx][ny] = nc;
+              cell(nx,ny) = nc;
             } else {
               if(nc.queueing != fwQueued){
                 open.push(nc.sqdist, INTPOINT(nx,ny));
                 nc.queueing = fwQueued;
-                data[nx][ny] = nc;
+                cell(nx,ny) = nc;
               }
             }
           }
@@ -196,9 +221,9 @@ void DynamicVoronoi::update(bool updateRealDist) {
       }
       c.needsRaise = false;
       c.queueing = bwProcessed;
-      data[x][y] = c;
+      cell(x,y) = c;
     }
-    else if (c.obstX != invalidObstData && isOccupied(c.obstX,c.obstY,data[c.obstX][c.obstY])) {
+    else if (c.obstX != invalidObstData && isOccupied(c.obstX,c.obstY,cell(c.obstX,c.obstY))) {
 
       // LOWER
       c.queueing = fwProcessed;
@@ -211,14 +236,14 @@ void DynamicVoronoi::update(bool updateRealDist) {
           if (dx==0 && dy==0) continue;
           int ny = y+dy;
           if (ny<=0 || ny>=sizeY-1) continue;
-          dataCell nc = data[nx][ny];
+          dataCell nc = cell(nx,ny);
           if(!nc.needsRaise) {
             int distx = nx-c.obstX;
             int disty = ny-c.obstY;
             int newSqDistance = distx*distx + disty*disty;
             bool overwrite =  (newSqDistance < nc.sqdist);
             if(!overwrite && newSqDistance==nc.sqdist) {
-              if (nc.obstX == invalidObstData || isOccupied(nc.obstX,nc.obstY,data[nc.obstX][nc.obstY])==false) overwrite = true;
+              if (nc.obstX == invalidObstData || isOccupied(nc.obstX,nc.obstY,cell(nc.obstX,nc.obstY))==false) overwrite = true;
             }
             if (overwrite) {
               open.push(newSqDistance, INTPOINT(nx,ny));
@@ -232,33 +257,175 @@ void DynamicVoronoi::update(bool updateRealDist) {
             } else {
               checkVoro(x,y,nx,ny,c,nc);
             }
-            data[nx][ny] = nc;
+            cell(nx,ny) = nc;
           }
         }
       }
     }
-    data[x][y] = c;
+    cell(x,y) = c;
   }
 }
 
 float DynamicVoronoi::getDistance( int x, int y ) {
-  if( (x>0) && (x<sizeX) && (y>0) && (y<sizeY)) return data[x][y].dist;
+  if( (x>0) && (x<sizeX) && (y>0) && (y<sizeY)) return getCell(x,y).dist;
   else return -INFINITY;
 }
 
 bool DynamicVoronoi::isVoronoi( int x, int y ) {
-  dataCell c = data[x][y];
+  dataCell c = cell(x,y);
   return (c.voronoi==free || c.voronoi==voronoiKeep);
 }
 
 
+void DynamicVoronoi::updateExact(ThreadPool& pool) {
+  // the transform starts from the binary map, pending changes are part of it already
+  addList.clear();
+  removeList.clear();
+  while (!open.empty()) open.pop();
+
+  const int inf = sizeX + sizeY;
+  updateRowDist(pool);
+
+  // the lower envelope of the parabolas of the rows along every column (Meijster et al.)
+  pool.parallelFor(sizeY, [&](int begin, int end) {
+    std::vector<int> s(sizeX), t(sizeX);
+
+    for (int y=begin; y<end; y++) {
+      int q = -1;
+      for (int u=0; u<sizeX; u++) {
+        int gu = rowDist[u*sizeY+y];
+        if (gu >= inf) continue;
+        while (q>=0) {
+          int gs = rowDist[s[q]*sizeY+y];
+          int ds = t[q]-s[q], du = t[q]-u;
+          if (ds*ds + gs*gs <= du*du + gu*gu) break;
+          q--;
+        }
+        if (q<0) {
+          q = 0;
+          s[0] = u;
+          t[0] = 0;
+        } else {
+          int gs = rowDist[s[q]*sizeY+y];
+          int w = 1 + (u*u - s[q]*s[q] + gu*gu - gs*gs) / (2*(u-s[q]));
+          if (w < sizeX) {
+            q++;
+            s[q] = u;
+            t[q] = w;
+          }
+        }
+      }
+      // a column without obstacles keeps its empty cells
+      for (int x=sizeX-1; x>=0 && q>=0; x--) {
+        int i = s[q];
+        if (x == t[q]) q--;
+        // the brushfire never lowers the border, only its obstacles
+        bool border = x==0 || x==sizeX-1 || y==0 || y==sizeY-1;
+        if (border && !gridCell(x,y)) continue;
+
+        int gi = rowDist[i*sizeY+y];
+        int oy = y-gi >= 0 && gridCell(i,y-gi) ? y-gi : y+gi;
+        dataCell& c = cell(x,y);
+        c.sqdist = (x-i)*(x-i) + gi*gi;
+        c.dist = sqrt((double) c.sqdist);
+        c.obstX = i;
+        c.obstY = oy;
+        c.queueing = fwProcessed;
+        c.needsRaise = false;
+      }
+    }
+  });
+
+  // a cell is on the diagram where checkVoro of the brushfire would add it, comparing it with every neighbor
+  pool.parallelFor(sizeX, [&](int begin, int end) {
+    for (int x=begin; x<end; x++) {
+      for (int y=0; y<sizeY; y++) {
+        dataCell& c = cell(x,y);
+        if (c.obstX == invalidObstData) continue;
+        c.voronoi = occupied;
+        if (c.sqdist <= 2 || x<=0 || x>=sizeX-1 || y<=0 || y>=sizeY-1) continue;
+
+        for (int dx=-1; dx<=1 && c.voronoi!=free; dx++) {
+          int nx = x+dx;
+          if (nx<=0 || nx>=sizeX-1) continue;
+          for (int dy=-1; dy<=1; dy++) {
+            if (dx==0 && dy==0) continue;
+            int ny = y+dy;
+            if (ny<=0 || ny>=sizeY-1) continue;
+            const dataCell& nc = cell(nx,ny);
+            if (nc.obstX == invalidObstData) continue;
+            if (abs(c.obstX-nc.obstX) <= 1 && abs(c.obstY-nc.obstY) <= 1) continue;
+
+            int stability_xy = (x-nc.obstX)*(x-nc.obstX) + (y-nc.obstY)*(y-nc.obstY) - c.sqdist;
+            int stability_nxy = (nx-c.obstX)*(nx-c.obstX) + (ny-c.obstY)*(ny-c.obstY) - nc.sqdist;
+            if (stability_xy <= stability_nxy) {
+              c.voronoi = free;
+              break;
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+void DynamicVoronoi::updateRowDist(ThreadPool& pool) {
+  const int inf = sizeX + sizeY;
+  rowDist.resize(sizeX*sizeY);
+
+  // the distance to the closest obstacle within the row, forward and backward
+  pool.parallelFor(sizeX, [&](int begin, int end) {
+    for (int x=begin; x<end; x++) {
+      int* g = &rowDist[x*sizeY];
+      int last = -inf;
+      for (int y=0; y<sizeY; y++) {
+        if (gridCell(x,y)) last = y;
+        g[y] = y-last;
+      }
+      last = 2*inf;
+      for (int y=sizeY-1; y>=0; y--) {
+        if (gridCell(x,y)) last = y;
+        if (last-y < g[y]) g[y] = last-y;
+        if (g[y] > inf) g[y] = inf;
+      }
+    }
+  });
+}
+
+void DynamicVoronoi::computeCell(int x, int y, dataCell& c) {
+  // the closest obstacle among the rows, moving away from the row of the cell until no row can be closer
+  const int inf = sizeX + sizeY;
+  int best = INT_MAX;
+  int row = -1;
+  for (int d=0; d*d<best && (x-d>=0 || x+d<sizeX); d++) {
+    for (int i=x-d; i<=x+d; i+=(d>0 ? 2*d : 1)) {
+      if (i<0 || i>=sizeX) continue;
+      int g = rowDist[i*sizeY+y];
+      if (g>=inf) continue;
+      if (d*d + g*g < best) {
+        best = d*d + g*g;
+        row = i;
+      }
+    }
+  }
+
+  if (row>=0) {
+    int g = rowDist[row*sizeY+y];
+    c.sqdist = best;
+    c.dist = sqrt((double) best);
+    c.obstX = row;
+    c.obstY = y-g>=0 && gridCell(row,y-g) ? y-g : y+g;
+  }
+  c.queueing = fwProcessed;
+}
+
 void DynamicVoronoi::commitAndColorize(bool updateRealDist) {
   // ADD NEW OBSTACLES
   for (unsigned int i=0; i<addList.size(); i++) {
     INTPOINT p = addList[i];
     int x = p.x;
     int y = p.y;
-    dataCell c = data[x][y];
+    dataCell c = cell(x,y);
 
     if(c.queueing != fwQueued){
       if (updateRealDist) c.dist = 0;
@@ -267,7 +434,7 @@ void DynamicVoronoi::commitAndColorize(bool updateRealDist) {
       c.obstY = y;
       c.queueing = fwQueued;
       c.voronoi = occupied;
-      data[x][y] = c;
+      cell(x,y) = c;
       open.push(0, INTPOINT(x,y));
     }
   }
@@ -277,14 +444,14 @@ void DynamicVoronoi::commitAndColorize(bool updateRealDist) {
     INTPOINT p = removeList[i];
     int x = p.x;
     int y = p.y;
-    dataCell c = data[x][y];
+    dataCell c = cell(x,y);
 
     if (isOccupied(x,y,c)==true) continue; // obstacle was removed and reinserted
     open.push(0, INTPOINT(x,y));
     if (updateRealDist) c.dist  = INFINITY;
     c.sqdist = INT_MAX;
     c.needsRaise = true;
-    data[x][y] = c;
+    cell(x,y) = c;
   }
   removeList.clear();
   addList.clear();
@@ -337,10 +504,10 @@ void DynamicVoronoi::reviveVoroNeighbors(int &x, int &y) {
       if (dx==0 && dy==0) continue;
       int ny = y+dy;
       if (ny<=0 || ny>=sizeY-1) continue;
-      dataCell nc = data[nx][ny];
+      dataCell nc = cell(nx,ny);
       if (nc.sqdist != INT_MAX && !nc.needsRaise && (nc.voronoi == voronoiKeep || nc.voronoi == voronoiPrune)) {
         nc.voronoi = free;
-        data[nx][ny] = nc;
+        cell(nx,ny) = nc;
         pruneQueue.push(INTPOINT(nx,ny));
       }
     }
@@ -349,11 +516,11 @@ void DynamicVoronoi::reviveVoroNeighbors(int &x, int &y) {
 
 
 bool DynamicVoronoi::isOccupied(int x, int y) {
-  dataCell c = data[x][y];
+  dataCell c = cell(x,y);
   return (c.obstX==x && c.obstY==y);
 }
 
-bool DynamicVoronoi::isOccupied(int &x, int &y, dataCell &c) {
+bool DynamicVoronoi::isOccupied(int x, int y, const dataCell &c) {
   return (c.obstX==x && c.obstY==y);
 }
 
@@ -375,12 +542,12 @@ void DynamicVoronoi::visualize(const char *filename) {
         fputc( 255, F );
         fputc( 0, F );
         fputc( 0, F );
-      } else if (data[x][y].sqdist==0) {
+      } else if (cell(x,y).sqdist==0 || gridCell(x,y)) {
         fputc( 0, F );
         fputc( 0, F );
         fputc( 0, F );
       } else {
-        float f = 80+(data[x][y].dist*5);
+        float f = 80+(cell(x,y).dist*5);
         if (f>255) f=255;
         if (f<0) f=0;
         c = (unsigned char)f;
@@ -402,58 +569,58 @@ void DynamicVoronoi::prune() {
     int x = p.x;
     int y = p.y;
 
-    if (data[x][y].voronoi==occupied) continue;
-    if (data[x][y].voronoi==freeQueued) continue;
+    if (cell(x,y).voronoi==occupied) continue;
+    if (cell(x,y).voronoi==freeQueued) continue;
 
-    data[x][y].voronoi = freeQueued;
-    open.push(data[x][y].sqdist, p);
+    cell(x,y).voronoi = freeQueued;
+    open.push(cell(x,y).sqdist, p);
 
     /* tl t tr
        l c r
        bl b br */
 
     dataCell tr,tl,br,bl;
-    tr = data[x+1][y+1];
-    tl = data[x-1][y+1];
-    br = data[x+1][y-1];
-    bl = data[x-1][y-1];
+    tr = cell(x+1,y+1);
+    tl = cell(x-1,y+1);
+    br = cell(x+1,y-1);
+    bl = cell(x-1,y-1);
 
     dataCell r,b,t,l;
-    r = data[x+1][y];
-    l = data[x-1][y];
-    t = data[x][y+1];
-    b = data[x][y-1];
+    r = cell(x+1,y);
+    l = cell(x-1,y);
+    t = cell(x,y+1);
+    b = cell(x,y-1);
 
     if (x+2<sizeX && r.voronoi==occupied) {
       // fill to the right
-      if (tr.voronoi!=occupied && br.voronoi!=occupied && data[x+2][y].voronoi!=occupied) {
+      if (tr.voronoi!=occupied && br.voronoi!=occupied && cell(x+2,y).voronoi!=occupied) {
         r.voronoi = freeQueued;
         open.push(r.sqdist, INTPOINT(x+1,y));
-        data[x+1][y] = r;
+        cell(x+1,y) = r;
       }
     }
     if (x-2>=0 && l.voronoi==occupied) {
       // fill to the left
-      if (tl.voronoi!=occupied && bl.voronoi!=occupied && data[x-2][y].voronoi!=occupied) {
+      if (tl.voronoi!=occupied && bl.voronoi!=occupied && cell(x-2,y).voronoi!=occupied) {
         l.voronoi = freeQueued;
         open.push(l.sqdist, INTPOINT(x-1,y));
-        data[x-1][y] = l;
+        cell(x-1,y) = l;
       }
     }
     if (y+2<sizeY && t.voronoi==occupied) {
       // fill to the top
-      if (tr.voronoi!=occupied && tl.voronoi!=occupied && data[x][y+2].voronoi!=occupied) {
+      if (tr.voronoi!=occupied && tl.voronoi!=occupied && cell(x,y+2).voronoi!=occupied) {
         t.voronoi = freeQueued;
         open.push(t.sqdist, INTPOINT(x,y+1));
-        data[x][y+1] = t;
+        cell(x,y+1) = t;
       }
     }
     if (y-2>=0 && b.voronoi==occupied) {
       // fill to the bottom
-      if (br.voronoi!=occupied && bl.voronoi!=occupied && data[x][y-2].voronoi!=occupied) {
+      if (br.voronoi!=occupied && bl.voronoi!=occupied && cell(x,y-2).voronoi!=occupied) {
         b.voronoi = freeQueued;
         open.push(b.sqdist, INTPOINT(x,y-1));
-        data[x][y-1] = b;
+        cell(x,y-1) = b;
       }
     }
   }
@@ -461,7 +628,7 @@ void DynamicVoronoi::prune() {
 
   while(!open.empty()) {
     INTPOINT p = open.pop();
-    dataCell c = data[p.x][p.y];
+    dataCell c = cell(p.x,p.y);
     int v = c.voronoi;
     if (v!=freeQueued && v!=voronoiRetry) { // || v>free || v==voronoiPrune || v==voronoiKeep) {
       //      assert(v!=retry);
@@ -476,13 +643,13 @@ void DynamicVoronoi::prune() {
       //      printf("RETRY %d %d\n", x, sizeY-1-y);
       pruneQueue.push(p);
     }
-    data[p.x][p.y] = c;
+    cell(p.x,p.y) = c;
 
     if (open.empty()) {
       while (!pruneQueue.empty()) {
         INTPOINT p = pruneQueue.front();
         pruneQueue.pop();
-        open.push(data[p.x][p.y].sqdist, p);
+        open.push(cell(p.x,p.y).sqdist, p);
       }
     }
   }
@@ -508,7 +675,7 @@ DynamicVoronoi::markerMatchResult DynamicVoronoi::markerMatch(int x, int y) {
     for (dx=-1; dx<=1; dx++) {
       if (dx || dy) {
         nx = x+dx;
-        dataCell nc = data[nx][ny];
+        dataCell nc = cell(nx,ny);
         int v = nc.voronoi;
         bool b = (v<=free && v!=voronoiPrune);
         //	if (v==occupied) obstacleCount++;
@@ -536,7 +703,7 @@ DynamicVoronoi::markerMatchResult DynamicVoronoi::markerMatch(int x, int y) {
 
 
   // keep voro cells inside of blocks and retry later
-  if (voroCount>=5 && voroCountFour>=3 && data[x][y].voronoi!=voronoiRetry) {
+  if (voroCount>=5 && voroCountFour>=3 && cell(x,y).voronoi!=voronoiRetry) {
     return retry;
   }
 
@@ -0,0 +1,113 @@
+#include "headinglayers.h"
+
+#include <algorithm>
+
+#include "lookup.h"
+#include "parameters.h"
+
+using namespace HybridAStar;
+
+namespace {
+/// returns the word w of a row, the words beyond the row are empty
+inline uint64_t word(const uint64_t* row, int stride, int w) { return w >= 0 && w < stride ? row[w] : 0; }
+
+/// returns the word w of a row shifted by a number of columns, the bit y of the result holds the column y + shift of the row
+inline uint64_t shifted(const uint64_t* row, int stride, int w, int shift) {
+  const int bits = BinaryGrid::wordBits;
+  int q = shift >= 0 ? shift / bits : -((bits - 1 - shift) / bits);
+  int r = shift - q * bits;
+  uint64_t low = word(row, stride, w + q);
+  return r ? (low >> r) | (word(row, stride, w + q + 1) << (bits - r)) : low;
+}
+}
+
+//###################################################
+//                                         FOOTPRINTS
+//###################################################
+HeadingLayers::HeadingLayers() {
+  const Constants::config* lookup = Lookup::sharedCollisionLookup();
+  const int headings = Parameters::get().headings;
+  // the cells of a footprint on a scratch grid centered at the cell of the configuration
+  const int size = 2 * Parameters::get().bbSize() + 2;
+  const int origin = size / 2;
+  std::vector<char> cells(size * size);
+  int minY = 0;
+  runs.resize(headings);
+
+  for (int iT = 0; iT < headings; ++iT) {
+    std::fill(cells.begin(), cells.end(), 0);
+
+    for (int i = 0; i < Constants::positions; ++i) {
+      const Constants::config& config = lookup[i * headings + iT];
+
+      for (int j = 0; j < config.length; ++j) {
+        cells[(origin + config.pos[j].x) * size + origin + config.pos[j].y] = 1;
+      }
+    }
+
+    for (int x = 0; x < size; ++x) {
+      for (int y = 0; y < size; ++y) {
+        if (!cells[x * size + y]) { continue; }
+
+        Run run = {x - origin, y - origin, 0};
+
+        while (y < size && cells[x * size + y]) {
+          ++run.length;
+          ++y;
+        }
+
+        runs[iT].push_back(run);
+        maxLength = std::max(maxLength, run.length);
+        minY = std::min(minY, run.y);
+      }
+    }
+  }
+
+  padding = (BinaryGrid::wordBits - 1 - minY) / BinaryGrid::wordBits;
+}
+
+//###################################################
+//                                           DILATION
+//###################################################
+void HeadingLayers::update(const BinaryGrid& grid) {
+  sizeX = grid.getSizeX();
+  sizeY = grid.getSizeY();
+  stride = (sizeY + BinaryGrid::wordBits - 1) / BinaryGrid::wordBits;
+  const int spanStride = stride + padding;
+  spans.resize(maxLength * sizeX * spanStride);
+  layers.resize(runs.size() * sizeX * stride);
+
+  // the rows OR-ed over every run length, each length adding the row shifted by one more column,
+  // with empty words on the left so runs starting left of the map keep the obstacles they reach on it
+  for (int x = 0; x < sizeX; ++x) {
+    uint64_t* row = &spans[x * spanStride];
+    std::fill(row, row + padding, 0);
+
+    for (int w = 0; w < stride; ++w) { row[padding + w] = grid.cells(x, w * BinaryGrid::wordBits); }
+
+    for (int l = 1; l < maxLength; ++l) {
+      uint64_t* span = &spans[(l * sizeX + x) * spanStride];
+      const uint64_t* previous = &spans[((l - 1) * sizeX + x) * spanStride];
+
+      for (int w = 0; w < spanStride; ++w) { span[w] = previous[w] | shifted(row, spanStride, w, l); }
+    }
+  }
+
+  // a cell of a layer is blocked if any run of the footprint placed there covers an obstacle
+  for (int iT = 0; iT < (int)runs.size(); ++iT) {
+    for (int x = 0; x < sizeX; ++x) {
+      uint64_t* layer = &layers[(iT * sizeX + x) * stride];
+      std::fill(layer, layer + stride, 0);
+
+      for (const Run& run : runs[iT]) {
+        int row = x + run.x;
+
+        if (row < 0 || row >= sizeX) { continue; }
+
+        const uint64_t* span = &spans[((run.length - 1) * sizeX + row) * spanStride];
+
+        for (int w = 0; w < stride; ++w) { layer[w] |= shifted(span, spanStride, padding + w, run.y); }
+      }
+    }
+  }
+}
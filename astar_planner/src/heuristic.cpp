@@ -0,0 +1,254 @@
+#include "heuristic.h"
+#include "dubins.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace HybridAStar;
+
+namespace {
+const double pi = M_PI;
+const double twoPi = 2. * M_PI;
+
+//###################################################
+//                                       REEDS-SHEPP
+//###################################################
+// The formulas, comments and names follow Reeds and Shepp, "Optimal paths for a car that goes both forwards and backwards", as OMPL does.
+// Every family is tried on the original pose and its timeflipped, reflected and timeflipped + reflected variants,
+// which only changes the word but not the length of the path.
+const double rsZero = 10 * std::numeric_limits<double>::epsilon();
+
+/// normalizes an angle to (-PI,PI]
+inline double rsMod2Pi(double x) {
+  double v = std::fmod(x, twoPi);
+
+  if (v < -pi) { v += twoPi; }
+  else if (v > pi) { v -= twoPi; }
+
+  return v;
+}
+
+inline void polar(double x, double y, double& r, double& theta) {
+  r = std::sqrt(x * x + y * y);
+  theta = std::atan2(y, x);
+}
+
+inline void tauOmega(double u, double v, double xi, double eta, double phi, double& tau, double& omega) {
+  double delta = rsMod2Pi(u - v), A = std::sin(u) - std::sin(delta), B = std::cos(u) - std::cos(delta) - 1.;
+  double t1 = std::atan2(eta * A - xi * B, xi * A + eta * B), t2 = 2. * (std::cos(delta) - std::cos(v) - std::cos(u)) + 3;
+  tau = (t2 < 0) ? rsMod2Pi(t1 + pi) : rsMod2Pi(t1);
+  omega = rsMod2Pi(tau - u + v - phi);
+}
+
+// formula 8.1
+inline bool LpSpLp(double x, double y, double phi, double& t, double& u, double& v) {
+  polar(x - std::sin(phi), y - 1. + std::cos(phi), u, t);
+
+  if (t >= -rsZero) {
+    v = rsMod2Pi(phi - t);
+
+    if (v >= -rsZero) { return true; }
+  }
+
+  return false;
+}
+
+// formula 8.2
+inline bool LpSpRp(double x, double y, double phi, double& t, double& u, double& v) {
+  double t1, u1;
+  polar(x + std::sin(phi), y - 1. - std::cos(phi), u1, t1);
+  u1 = u1 * u1;
+
+  if (u1 >= 4.) {
+    u = std::sqrt(u1 - 4.);
+    double theta = std::atan2(2., u);
+    t = rsMod2Pi(t1 + theta);
+    v = rsMod2Pi(t - phi);
+    return t >= -rsZero && v >= -rsZero;
+  }
+
+  return false;
+}
+
+// formula 8.3 / 8.4, with the typo of the paper corrected
+inline bool LpRmL(double x, double y, double phi, double& t, double& u, double& v) {
+  double xi = x - std::sin(phi), eta = y - 1. + std::cos(phi), u1, theta;
+  polar(xi, eta, u1, theta);
+
+  if (u1 <= 4.) {
+    u = -2. * std::asin(.25 * u1);
+    t = rsMod2Pi(theta + .5 * u + pi);
+    v = rsMod2Pi(phi - t + u);
+    return t >= -rsZero && u <= rsZero;
+  }
+
+  return false;
+}
+
+// formula 8.7
+inline bool LpRupLumRm(double x, double y, double phi, double& t, double& u, double& v) {
+  double xi = x + std::sin(phi), eta = y - 1. - std::cos(phi), rho = .25 * (2. + std::sqrt(xi * xi + eta * eta));
+
+  if (rho <= 1.) {
+    u = std::acos(rho);
+    tauOmega(u, -u, xi, eta, phi, t, v);
+    return t >= -rsZero && v <= rsZero;
+  }
+
+  return false;
+}
+
+// formula 8.8
+inline bool LpRumLumRp(double x, double y, double phi, double& t, double& u, double& v) {
+  double xi = x + std::sin(phi), eta = y - 1. - std::cos(phi), rho = (20. - xi * xi - eta * eta) / 16.;
+
+  if (rho >= 0 && rho <= 1) {
+    u = -std::acos(rho);
+
+    if (u >= -.5 * pi) {
+      tauOmega(u, u, xi, eta, phi, t, v);
+      return t >= -rsZero && v >= -rsZero;
+    }
+  }
+
+  return false;
+}
+
+// formula 8.9
+inline bool LpRmSmLm(double x, double y, double phi, double& t, double& u, double& v) {
+  double xi = x - std::sin(phi), eta = y - 1. + std::cos(phi), rho, theta;
+  polar(xi, eta, rho, theta);
+
+  if (rho >= 2.) {
+    double r = std::sqrt(rho * rho - 4.);
+    u = 2. - r;
+    t = rsMod2Pi(theta + std::atan2(r, -2.));
+    v = rsMod2Pi(phi - .5 * pi - t);
+    return t >= -rsZero && u <= rsZero && v <= rsZero;
+  }
+
+  return false;
+}
+
+// formula 8.10
+inline bool LpRmSmRm(double x, double y, double phi, double& t, double& u, double& v) {
+  double xi = x + std::sin(phi), eta = y - 1. - std::cos(phi), rho, theta;
+  polar(-eta, xi, rho, theta);
+
+  if (rho >= 2.) {
+    t = theta;
+    u = 2. - rho;
+    v = rsMod2Pi(t + .5 * pi - phi);
+    return t >= -rsZero && u <= rsZero && v <= rsZero;
+  }
+
+  return false;
+}
+
+// formula 8.11, with the typo of the paper corrected
+inline bool LpRmSLmRp(double x, double y, double phi, double& t, double& u, double& v) {
+  double xi = x + std::sin(phi), eta = y - 1. - std::cos(phi), rho, theta;
+  polar(xi, eta, rho, theta);
+
+  if (rho >= 2.) {
+    u = 4. - std::sqrt(rho * rho - 4.);
+
+    if (u <= rsZero) {
+      t = rsMod2Pi(std::atan2((4 - u) * xi - 2 * eta, -2 * xi + (u - 4) * eta));
+      v = rsMod2Pi(t - phi);
+      return t >= -rsZero && v >= -rsZero;
+    }
+  }
+
+  return false;
+}
+
+/// the signature shared by all formulas
+typedef bool (*RSFormula)(double, double, double, double&, double&, double&);
+
+/*!
+   \brief Lowers length to the shortest path of a formula over the pose and its timeflip, reflect and timeflip + reflect variants
+   \param weightU the number of times the u segment appears in the word
+   \param extra the length of the fixed quarter turns of the word
+*/
+inline void tryFormula(RSFormula formula, double x, double y, double phi, double weightU, double extra, double& length) {
+  double t, u, v;
+
+  if (formula(x, y, phi, t, u, v)) { length = std::min(length, std::fabs(t) + weightU * std::fabs(u) + std::fabs(v) + extra); }
+  // timeflip
+  if (formula(-x, y, -phi, t, u, v)) { length = std::min(length, std::fabs(t) + weightU * std::fabs(u) + std::fabs(v) + extra); }
+  // reflect
+  if (formula(x, -y, -phi, t, u, v)) { length = std::min(length, std::fabs(t) + weightU * std::fabs(u) + std::fabs(v) + extra); }
+  // timeflip + reflect
+  if (formula(-x, -y, phi, t, u, v)) { length = std::min(length, std::fabs(t) + weightU * std::fabs(u) + std::fabs(v) + extra); }
+}
+
+/// the length of the shortest Reeds-Shepp path to the normalized pose (x,y,phi) relative to the start
+inline double reedsShepp(double x, double y, double phi) {
+  double length = INFINITY;
+  // the pose seen backwards from the goal, used by the words that are read in reverse
+  double xb = x * std::cos(phi) + y * std::sin(phi);
+  double yb = x * std::sin(phi) - y * std::cos(phi);
+
+  // CSC
+  tryFormula(LpSpLp, x, y, phi, 1., 0., length);
+  tryFormula(LpSpRp, x, y, phi, 1., 0., length);
+  // CCC
+  tryFormula(LpRmL, x, y, phi, 1., 0., length);
+  tryFormula(LpRmL, xb, yb, phi, 1., 0., length);
+  // CCCC
+  tryFormula(LpRupLumRm, x, y, phi, 2., 0., length);
+  tryFormula(LpRumLumRp, x, y, phi, 2., 0., length);
+  // CCSC
+  tryFormula(LpRmSmLm, x, y, phi, 1., .5 * pi, length);
+  tryFormula(LpRmSmRm, x, y, phi, 1., .5 * pi, length);
+  tryFormula(LpRmSmLm, xb, yb, phi, 1., .5 * pi, length);
+  tryFormula(LpRmSmRm, xb, yb, phi, 1., .5 * pi, length);
+  // CCSCC
+  tryFormula(LpRmSLmRp, x, y, phi, 1., pi, length);
+  return length;
+}
+}
+
+//###################################################
+//                                        DUBINS COST
+//###################################################
+float Heuristic::dubinsCost(float x0, float y0, float t0, float x1, float y1, float t1, float r) {
+  double q0[] = { x0, y0, t0 };
+  double q1[] = { x1, y1, t1 };
+  // the same solver as the Dubin's shot, its path lives on the stack
+  DubinsPath path;
+
+  if (dubins_init(q0, q1, r, &path) != EDUBOK) {
+    return std::numeric_limits<float>::infinity();
+  }
+
+  return dubins_path_length(&path);
+}
+
+void Heuristic::dubinsCost(const float* x, const float* y, const float* t, int n, float x1, float y1, float t1, float* cost, float r) {
+  for (int i = 0; i < n; ++i) {
+    cost[i] = dubinsCost(x[i], y[i], t[i], x1, y1, t1, r);
+  }
+}
+
+//###################################################
+//                                  REEDS-SHEPP COST
+//###################################################
+float Heuristic::reedsSheppCost(float x0, float y0, float t0, float x1, float y1, float t1, float r) {
+  double dx = (double)x1 - x0;
+  double dy = (double)y1 - y0;
+  double c = std::cos(t0);
+  double s = std::sin(t0);
+  // the goal in the frame of the start
+  double x = c * dx + s * dy;
+  double y = -s * dx + c * dy;
+  return r * reedsShepp(x / r, y / r, (double)t1 - t0);
+}
+
+void Heuristic::reedsSheppCost(const float* x, const float* y, const float* t, int n, float x1, float y1, float t1, float* cost, float r) {
+  for (int i = 0; i < n; ++i) {
+    cost[i] = reedsSheppCost(x[i], y[i], t[i], x1, y1, t1, r);
+  }
+}
@@ -2,6 +2,11 @@
 
 using namespace HybridAStar;
 
+// generations of the current search and plan and the last one handed out
+thread_local unsigned int Node2D::searchGeneration = 0;
+thread_local unsigned int Node2D::planGeneration = 0;
+std::atomic<unsigned int> Node2D::generations(0);
+
 // possible directions
 const int Node2D::dir = 8;
 // possible movements
@@ -18,10 +23,11 @@ bool Node2D::isOnGrid(const int width, const int height) const {
 //###################################################
 //                                   CREATE SUCCESSOR
 //###################################################
-Node2D* Node2D::createSuccessor(const int i) {
+Node2D* Node2D::createSuccessor(const int i, Node2D* succ) {
   int xSucc = x + Node2D::dx[i];
   int ySucc = y + Node2D::dy[i];
-  return new Node2D(xSucc, ySucc, g, 0, this);
+  *succ = Node2D(xSucc, ySucc, g, 0, this);
+  return succ;
 }
 
 //###################################################
@@ -1,7 +1,12 @@
 #include "node3d.h"
+#include "primitives.h"
 
 using namespace HybridAStar;
 
+// generation of the current search and the last one handed out
+thread_local unsigned int Node3D::generation = 0;
+std::atomic<unsigned int> Node3D::generations(0);
+
 // CONSTANT VALUES
 // possible directions
 const int Node3D::dir = 3;
@@ -40,7 +45,8 @@ const float Node3D::dt[] = { 0,         0.174533,   -0.174533};//in rad
 //                                         IS ON GRID
 //###################################################
 bool Node3D::isOnGrid(const int width, const int height) const {
-  return x >= 0 && x < width && y >= 0 && y < height && (int)(t / Constants::deltaHeadingRad) >= 0 && (int)(t / Constants::deltaHeadingRad) < Constants::headings;
+  int iT = (int)(t / Parameters::deltaHeading());
+  return x >= 0 && x < width && y >= 0 && y < height && iT >= 0 && iT < Parameters::get().headings;
 }
 
 
@@ -57,25 +63,15 @@ bool Node3D::isInRange(const Node3D& goal) const {
 //###################################################
 //                                   CREATE SUCCESSOR
 //###################################################
-Node3D* Node3D::createSuccessor(const int i) {
-  float xSucc;
-  float ySucc;
-  float tSucc;
-
-  // calculate successor positions forward
-  if (i < 3) {
-    xSucc = x + dx[i] * cos(t) - dy[i] * sin(t);
-    ySucc = y + dx[i] * sin(t) + dy[i] * cos(t);
-    tSucc = Helper::normalizeHeadingRad(t + dt[i]);
-  }
-  // backwards
-  else {
-    xSucc = x - dx[i - 3] * cos(t) - dy[i - 3] * sin(t);
-    ySucc = y - dx[i - 3] * sin(t) + dy[i - 3] * cos(t);
-    tSucc = Helper::normalizeHeadingRad(t - dt[i - 3]);
-  }
-
-  return new Node3D(xSucc, ySucc, tSucc, g, 0, this, i);
+Node3D* Node3D::createSuccessor(const int i, Node3D* succ) {
+  // the primitive rotated into the lattice heading closest to t, forward for i < 3 and backwards otherwise
+  const Primitives::Primitive& primitive = Primitives::get(Primitives::bin(t), i);
+  float xSucc = x + primitive.dx;
+  float ySucc = y + primitive.dy;
+  float tSucc = Primitives::heading(primitive.bin);
+
+  *succ = Node3D(xSucc, ySucc, tSucc, g, 0, this, i);
+  return succ;
 }
 
 
@@ -309,6 +305,6 @@ void Node3D::updateG() {
 bool Node3D::operator == (const Node3D& rhs) const {
   return std::abs((int)x - (int)rhs.x)<3 &&
          std::abs((int)y - (int)rhs.y)<3 &&
-         (std::abs(t - rhs.t) <= Constants::deltaHeadingRad ||
-          std::abs(t - rhs.t) >= Constants::deltaHeadingNegRad);
+         (std::abs(t - rhs.t) <= Parameters::deltaHeading() ||
+          std::abs(t - rhs.t) >= 2 * M_PI - Parameters::deltaHeading());
 }
@@ -0,0 +1,61 @@
+#include "parameters.h"
+
+#include <iostream>
+
+#include "opencv2/opencv.hpp"
+
+using namespace HybridAStar;
+
+Parameters Parameters::current;
+float Parameters::currentDeltaHeading = 2 * M_PI / Constants::headings;
+bool Parameters::frozen = false;
+
+bool Parameters::load(const std::string& file) {
+  cv::FileStorage config(file, cv::FileStorage::READ);
+
+  if (!config.isOpened()) {
+    std::cerr << "could not read the parameters from " << file << std::endl;
+    return false;
+  }
+
+  if (!config["Path.footprint_width"].empty()) { width = (float)config["Path.footprint_width"]; }
+
+  if (!config["Path.footprint_length"].empty()) { length = (float)config["Path.footprint_length"]; }
+
+  if (!config["Path.headings"].empty()) { headings = (int)config["Path.headings"]; }
+
+  return true;
+}
+
+bool Parameters::isValid() const {
+  if (headings <= 0 || 360 % headings != 0) {
+    std::cerr << "the number of headings " << headings << " has to divide 360" << std::endl;
+    return false;
+  }
+
+  if (width <= 0 || length <= 0) {
+    std::cerr << "the footprint " << width << " x " << length << " has to be positive" << std::endl;
+    return false;
+  }
+
+  // the tables store the cells of a footprint relative to its center in 8 bits
+  if (bbSize() > 127) {
+    std::cerr << "the footprint " << width << " x " << length << " spans " << bbSize() << " cells, at most 127 are supported" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool Parameters::set(const Parameters& parameters) {
+  if (frozen) {
+    std::cerr << "the parameters cannot change once the lookup tables are built" << std::endl;
+    return false;
+  }
+
+  if (!parameters.isValid()) { return false; }
+
+  current = parameters;
+  currentDeltaHeading = parameters.deltaHeadingRad();
+  return true;
+}
@@ -0,0 +1,123 @@
+#include "planner.h"
+
+#include "lookup.h"
+#include "stats.h"
+
+using namespace HybridAStar;
+
+Planner::~Planner() {
+  delete [] nodes3D;
+  delete [] nodes2D;
+  delete [] dubinsLookup;
+}
+
+void Planner::initializeDubinsLookup(const std::string& file) {
+  if (!dubinsLookup) { dubinsLookup = new float [Constants::dubinsSize]; }
+
+  // build the lookup only if there is no file matching the current constants
+  if (!Lookup::loadDubinsLookup(file.c_str(), dubinsLookup)) {
+    Lookup::dubinsLookup(dubinsLookup);
+    Lookup::saveDubinsLookup(file.c_str(), dubinsLookup);
+  }
+}
+
+//###################################################
+//                                                MAP
+//###################################################
+bool Planner::updateMap(const cv::Mat& gridmap) {
+  STATS_TIMER(voronoiTime);
+  // the configuration space converts the map once, the diagram builds on its grid
+  configurationSpace.updateGrid(gridmap);
+  width = gridmap.cols;
+  height = gridmap.rows;
+  const BinaryGrid& grid = configurationSpace.getGrid();
+  mapValid = false;
+
+  bool incremental = voronoiMode == Constants::VoronoiMode::incremental;
+
+  if (voronoiMode == Constants::VoronoiMode::lazy) {
+    // the search and the smoother query the distances of a small part of the map, they are computed when first queried
+    if (!voronoiDiagram.initializeLazy(grid, threadPool)) { return refuseMap(); }
+  } else if (incremental && grid.changes(previousGrid, (int)(voronoiChangeShare * width * height), changedCells)) {
+    // feed the diagram only the cells that changed since the previous map, unless so many did that a rebuild is faster
+    for (const BinaryGrid::Change& change : changedCells) {
+      if (change.occupied) {
+        voronoiDiagram.occupyCell(change.x, change.y);
+      } else {
+        voronoiDiagram.clearCell(change.x, change.y);
+      }
+    }
+
+    voronoiDiagram.update();
+  } else if (voronoiMode == Constants::VoronoiMode::brushfire) {
+    if (!voronoiDiagram.initializeMap(grid)) { return refuseMap(); }
+
+    voronoiDiagram.update();
+  } else {
+    // a rebuild from scratch is faster as an exact distance transform than as a brushfire
+    if (!voronoiDiagram.initializeMap(grid)) { return refuseMap(); }
+
+    voronoiDiagram.updateExact(threadPool);
+  }
+
+  configurationSpace.updateDistanceMap(&voronoiDiagram);
+
+  // only the incremental mode compares the next map against this one, the other modes leave the diagram out of step with it
+  previousGrid = incremental ? grid : BinaryGrid();
+
+  mapValid = true;
+  return true;
+}
+
+bool Planner::refuseMap() {
+  // the next map of a supported size is rebuilt from scratch, no plan runs on the empty diagram until then
+  configurationSpace.updateDistanceMap(nullptr);
+  previousGrid = BinaryGrid();
+  return false;
+}
+
+//###################################################
+//                                               PLAN
+//###################################################
+bool Planner::plan(Node3D& start, const Node3D& goal) {
+  path.clear();
+  smoothedPath.clear();
+
+  if (!mapValid) { return false; }
+
+  // allocate the lists only when the map size changes, the search invalidates them through the node generation
+  int length = width * height * Parameters::get().headings;
+
+  if (length != nodes3DLength) {
+    delete [] nodes3D;
+    delete [] nodes2D;
+    nodes3D = new Node3D[length]();
+    nodes2D = new Node2D[width * height]();
+    nodes3DLength = length;
+  }
+
+  bound = 1.f;
+
+  bool found;
+
+  {
+    STATS_TIMER(searchTime);
+
+    if (Constants::incremental) {
+      found = replanner.plan(start, goal, nodes3D, nodes2D, searchContext, width, height, configurationSpace, dubinsLookup, deadline, path, bound);
+    } else {
+      found = Algorithm::search(start, goal, nodes3D, nodes2D, searchContext, width, height, configurationSpace, dubinsLookup, deadline, path, bound);
+    }
+  }
+
+  STATS_ADD(pathLength, path.size());
+  STATS_ADD(pathCost, found ? path.front().getG() : 0);
+  STATS_ADD(bound, found ? bound : 0);
+
+  if (!found) { return false; }
+
+  smoother.setPath(path);
+  smoother.smoothPath(voronoiDiagram);
+  smoothedPath = smoother.getPath();
+  return true;
+}
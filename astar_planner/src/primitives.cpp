@@ -0,0 +1,41 @@
+#include "primitives.h"
+#include "node3d.h"
+#include "helper.h"
+
+using namespace HybridAStar;
+
+constexpr float Primitives::deltaBinRad;
+Primitives::Primitive Primitives::table[Primitives::bins][Primitives::count];
+float Primitives::cosTable[Primitives::bins];
+float Primitives::sinTable[Primitives::bins];
+const bool Primitives::built = Primitives::build();
+
+//###################################################
+//                                        TABLE SETUP
+//###################################################
+bool Primitives::build() {
+  for (int b = 0; b < bins; ++b) {
+    double t = b * 2 * M_PI / bins;
+    double cosT = std::cos(t);
+    double sinT = std::sin(t);
+    cosTable[b] = cosT;
+    sinTable[b] = sinT;
+
+    for (int i = 0; i < count; ++i) {
+      // forward
+      if (i < 3) {
+        table[b][i].dx = Node3D::dx[i] * cosT - Node3D::dy[i] * sinT;
+        table[b][i].dy = Node3D::dx[i] * sinT + Node3D::dy[i] * cosT;
+        table[b][i].bin = bin(Helper::normalizeHeadingRad(t + Node3D::dt[i]));
+      }
+      // backwards
+      else {
+        table[b][i].dx = -Node3D::dx[i - 3] * cosT - Node3D::dy[i - 3] * sinT;
+        table[b][i].dy = -Node3D::dx[i - 3] * sinT + Node3D::dy[i - 3] * cosT;
+        table[b][i].bin = bin(Helper::normalizeHeadingRad(t - Node3D::dt[i - 3]));
+      }
+    }
+  }
+
+  return true;
+}
@@ -0,0 +1,194 @@
+#include "replanner.h"
+#include "clock.h"
+#include "helper.h"
+
+using namespace HybridAStar;
+
+namespace {
+/// the distance in cells between two nodes
+inline float distance(const Node3D& lhs, const Node3D& rhs) {
+  float dx = lhs.getX() - rhs.getX();
+  float dy = lhs.getY() - rhs.getY();
+  return std::sqrt(dx * dx + dy * dy);
+}
+
+/// the absolute difference of two headings in [0,PI]
+inline float headingDifference(float t0, float t1) {
+  float dt = std::abs(t0 - t1);
+  return dt > M_PI ? 2.f * M_PI - dt : dt;
+}
+
+/// whether the vehicle stays safe on the straight join between two poses, sampled at the step of the Dubin's shot
+bool isJoinable(const Node3D& from, const Node3D& to, CollisionDetection& configurationSpace) {
+  int n = std::max(1, (int)std::ceil(distance(from, to) / Constants::dubinsStepSize));
+  // the signed heading change in (-PI,PI]
+  float dt = Helper::normalizeHeadingRad(to.getT() - from.getT());
+  dt = dt > M_PI ? dt - 2.f * M_PI : dt;
+  std::vector<Node3D> samples(n + 1);
+
+  for (int i = 0; i <= n; ++i) {
+    float u = (float)i / n;
+    samples[i] = Node3D(from.getX() + u * (to.getX() - from.getX()), from.getY() + u * (to.getY() - from.getY()),
+                        Helper::normalizeHeadingRad(from.getT() + u * dt), 0, 0, nullptr);
+  }
+
+  return configurationSpace.areTraversable(&samples[0], n + 1);
+}
+}
+
+//###################################################
+//                                              SHIFT
+//###################################################
+void Replanner::shift(const Node3D& from, const Node3D& to) {
+  // rotate by the heading change around the vehicle and translate it onto its new position
+  float dt = to.getT() - from.getT();
+  float c = std::cos(dt);
+  float s = std::sin(dt);
+
+  previous.push_back(previousGoal);
+
+  for (Node3D& node : previous) {
+    float x = node.getX() - from.getX();
+    float y = node.getY() - from.getY();
+    node.setX(to.getX() + c * x - s * y);
+    node.setY(to.getY() + s * x + c * y);
+    node.setT(Helper::normalizeHeadingRad(node.getT() + dt));
+    // the predecessors point into the nodes of the previous search
+    node.setPred(nullptr);
+  }
+
+  previousGoal = previous.back();
+  previous.pop_back();
+}
+
+//###################################################
+//                                             REJOIN
+//###################################################
+int Replanner::rejoin(const Node3D& start) const {
+  int index = -1;
+  float closest = Constants::replanTolerance;
+
+  // project the start onto every segment of the path, walking from its start towards the goal
+  for (int i = (int)previous.size() - 1; i > 0; --i) {
+    const Node3D& a = previous[i];
+    const Node3D& b = previous[i - 1];
+    float dx = b.getX() - a.getX();
+    float dy = b.getY() - a.getY();
+    float length = dx * dx + dy * dy;
+    float u = length > 0 ? ((start.getX() - a.getX()) * dx + (start.getY() - a.getY()) * dy) / length : 0;
+
+    if (u < 0 || u >= 1) { continue; }
+
+    float ex = a.getX() + u * dx - start.getX();
+    float ey = a.getY() + u * dy - start.getY();
+    float d = std::sqrt(ex * ex + ey * ey);
+
+    if (d <= closest && std::min(headingDifference(a.getT(), start.getT()), headingDifference(b.getT(), start.getT())) <= Parameters::deltaHeading()) {
+      closest = d;
+      index = i - 1;
+    }
+  }
+
+  return index;
+}
+
+//###################################################
+//                                               PLAN
+//###################################################
+bool Replanner::plan(Node3D& start,
+                     const Node3D& goal,
+                     Node3D* nodes3D,
+                     Node2D* nodes2D,
+                     SearchContext& context,
+                     int width,
+                     int height,
+                     CollisionDetection& configurationSpace,
+                     float* dubinsLookup,
+                     double deadline,
+                     std::vector<Node3D>& path,
+                     float& bound) {
+  double t0 = Clock::now();
+  // the index of the first node of the previous path ahead of the start
+  int first = previous.empty() || !(goal == previousGoal) ? -1 : rejoin(start);
+  // the index of the blocked node of the previous path that is closest to the start
+  int blocked = -1;
+  // the index of the node of the previous path the repair rejoins
+  int resume = -1;
+
+  if (first >= 0) {
+    // the start is joined straight onto the path, a join through an obstacle is repaired like a blocked node
+    if (!isJoinable(start, previous[first], configurationSpace)) {
+      blocked = first;
+    }
+
+    for (int i = first; i >= 0 && blocked < 0; --i) {
+      if (!previous[i].isOnGrid(width, height) || !configurationSpace.isTraversable(&previous[i])) {
+        blocked = i;
+      }
+    }
+
+    // the first node behind the blocked part that is followed by a free stretch of Constants::replanMargin cells
+    float free = 0;
+
+    for (int i = blocked - 1; i > 0 && resume < 0; --i) {
+      if (!previous[i].isOnGrid(width, height) || !configurationSpace.isTraversable(&previous[i])) {
+        free = 0;
+        continue;
+      }
+
+      free += distance(previous[i], previous[i + 1]);
+
+      if (free >= Constants::replanMargin) {
+        resume = i;
+      }
+    }
+  }
+
+  bool found;
+
+  // ___________________________
+  // REUSE THE UNBLOCKED PATH
+  if (first >= 0 && blocked < 0) {
+    std::cout << "replanner reused the previous path" << std::endl;
+    path.assign(previous.begin(), previous.begin() + first + 1);
+    path.push_back(start);
+    bound = previousBound;
+    found = true;
+  }
+  // ___________________________
+  // REPAIR THE BLOCKED PART
+  else if (first >= 0 && resume > 0) {
+    std::cout << "replanner repairs the previous path from node " << first << " to " << resume << std::endl;
+    std::vector<Node3D> repair;
+    Node3D via = previous[resume];
+    found = Algorithm::search(start, via, nodes3D, nodes2D, context, width, height, configurationSpace, dubinsLookup, deadline, repair, bound);
+
+    if (found) {
+      path.assign(previous.begin(), previous.begin() + resume);
+      path.insert(path.end(), repair.begin(), repair.end());
+      // the kept part carries the bound of the plan it stems from
+      bound = std::max(previousBound, bound);
+    }
+  } else {
+    found = false;
+  }
+
+  // ___________________________
+  // PLAN FROM SCRATCH
+  if (!found) {
+    double elapsed = Clock::now() - t0;
+    std::cout << "replanner plans from scratch" << std::endl;
+    found = Algorithm::search(start, goal, nodes3D, nodes2D, context, width, height, configurationSpace, dubinsLookup,
+                              std::max(0.0, deadline - elapsed), path, bound);
+  }
+
+  if (found) {
+    previous = path;
+    previousGoal = goal;
+    previousBound = bound;
+  } else {
+    previous.clear();
+  }
+
+  return found;
+}
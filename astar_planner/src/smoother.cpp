@@ -1,4 +1,5 @@
 #include "smoother.h"
+#include "stats.h"
 using namespace HybridAStar;
 //###################################################
 //                                     CUSP DETECTION
@@ -18,8 +19,10 @@ inline bool isCusp(std::vector<Node3D> path, int i) {
 //                                SMOOTHING ALGORITHM
 //###################################################
 void Smoother::smoothPath(DynamicVoronoi& voronoi) {
+  STATS_TIMER(smoothingTime);
   // load the current voronoi diagram into the smoother
-  this->voronoi = voronoi;
+  // the diagram owns its arrays, so it is referenced instead of copied
+  this->voronoi = &voronoi;
   this->width = voronoi.getSizeX();
   this->height = voronoi.getSizeY();
   // current number of iterations of the gradient descent smoother
@@ -76,6 +79,7 @@ void Smoother::smoothPath(DynamicVoronoi& voronoi) {
     }
 
     iterations++;
+    STATS_COUNT(smootherIterations);
   }
 
   path = newPath;
@@ -100,14 +104,14 @@ void Smoother::tracePath(const Node3D* node, int i, std::vector<Node3D> path) {
 Vector2D Smoother::obstacleTerm(Vector2D xi) {
   Vector2D gradient;
   // the distance to the closest obstacle from the current node
-  float obsDst = voronoi.getDistance(xi.getX(), xi.getY());
+  float obsDst = voronoi->getDistance(xi.getX(), xi.getY());
   // the vector determining where the obstacle is
   int x = (int)xi.getX();
   int y = (int)xi.getY();
   // if the node is within the map
   if (x < width && x >= 0 && y < height && y >= 0) {
-    Vector2D obsVct(xi.getX() - voronoi.data[(int)xi.getX()][(int)xi.getY()].obstX,
-                    xi.getY() - voronoi.data[(int)xi.getX()][(int)xi.getY()].obstY);
+    Vector2D obsVct(xi.getX() - voronoi->getCell((int)xi.getX(), (int)xi.getY()).obstX,
+                    xi.getY() - voronoi->getCell((int)xi.getX(), (int)xi.getY()).obstY);
 
     // the closest obstacle is closer than desired correct the path for that
     if (obsDst < obsDMax) {
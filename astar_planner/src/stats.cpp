@@ -0,0 +1,44 @@
+#include "stats.h"
+
+#include <fstream>
+
+using namespace HybridAStar;
+
+PlannerStats PlannerStats::current;
+
+//###################################################
+//                                                CSV
+//###################################################
+void PlannerStats::csvHeader(std::ostream& out) {
+  out << "searches,expansions,pushes,lazy_deletions,pruned,"
+      << "twod_searches,twod_expansions,twod_pushes,"
+      << "heuristic_evaluations,dubins_shots,dubins_shots_connected,collision_checks,smoother_iterations,"
+      << "path_length,path_cost,bound,"
+      << "voronoi_ms,search_ms,twod_ms,smoothing_ms,total_ms\n";
+}
+
+void PlannerStats::toCsv(std::ostream& out) const {
+  out << searches << ',' << expansions << ',' << pushes << ',' << lazyDeletions << ',' << pruned << ','
+      << twoDSearches << ',' << twoDExpansions << ',' << twoDPushes << ','
+      << heuristicEvaluations << ',' << dubinsShots << ',' << dubinsShotsConnected << ',' << collisionChecks << ',' << smootherIterations << ','
+      << pathLength << ',' << pathCost << ',' << bound << ','
+      << voronoiTime << ',' << searchTime << ',' << twoDTime << ',' << smoothingTime << ',' << totalTime << '\n';
+}
+
+bool PlannerStats::appendCsv(const char* file) const {
+  // an empty or missing file gets the header first
+  bool empty;
+  {
+    std::ifstream in(file, std::ios::binary | std::ios::ate);
+    empty = !in || in.tellg() == 0;
+  }
+
+  std::ofstream out(file, std::ios::app);
+
+  if (!out) { return false; }
+
+  if (empty) { csvHeader(out); }
+
+  toCsv(out);
+  return true;
+}
@@ -0,0 +1,141 @@
+#include "sweptvolume.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "binarygrid.h"
+#include "helper.h"
+#include "lookup.h"
+#include "node3d.h"
+#include "parameters.h"
+
+using namespace HybridAStar;
+
+const SweptVolume& SweptVolume::shared() {
+  static const SweptVolume table;
+  return table;
+}
+
+//###################################################
+//                                        TABLE SETUP
+//###################################################
+SweptVolume::SweptVolume() {
+  const Constants::config* lookup = Lookup::sharedCollisionLookup();
+  const Parameters& parameters = Parameters::get();
+  const int resolution = Constants::positionResolution;
+  const int part = resolution / buckets;
+  // the cells of one mask on a scratch grid centered at the cell of the predecessor, the footprint moving up to a primitive away
+  const int size = 2 * (parameters.bbSize() + (int)std::ceil(Node3D::dx[0]) + 2);
+  const int origin = size / 2;
+  std::vector<char> cells(size * size);
+
+  // the cells of every footprint of the lookup as runs of adjacent columns per row, a wide footprint is stamped a row at a time
+  struct Run {
+    int x;
+    int y;
+    int length;
+  };
+  std::vector<std::vector<Run>> runs(Constants::positions * parameters.headings);
+
+  for (unsigned int idx = 0; idx < runs.size(); ++idx) {
+    std::vector<std::pair<int, int>> sorted;
+
+    for (int c = 0; c < lookup[idx].length; ++c) { sorted.push_back(std::make_pair(lookup[idx].pos[c].x, lookup[idx].pos[c].y)); }
+
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+    for (unsigned int c = 0; c < sorted.size(); ++c) {
+      if (c > 0 && sorted[c].first == runs[idx].back().x && sorted[c].second == runs[idx].back().y + runs[idx].back().length) {
+        ++runs[idx].back().length;
+      } else {
+        Run run = {sorted[c].first, sorted[c].second, 1};
+        runs[idx].push_back(run);
+      }
+    }
+  }
+
+  masks.resize(Primitives::bins * count * buckets * buckets);
+
+  for (int bin = 0; bin < Primitives::bins; ++bin) {
+    const double t = Primitives::heading(bin);
+
+    for (int i = 0; i < count; ++i) {
+      // the primitive in the frame of the vehicle, an arc from the origin to (dx,dy) turning by dt
+      const bool forward = i < 3;
+      const int p = forward ? i : i - 3;
+      const double dt = Node3D::dt[p];
+      const double radius = dt == 0 ? 0 : Node3D::dx[p] / std::sin(std::abs(dt));
+      const double length = dt == 0 ? Node3D::dx[p] : radius * std::abs(dt);
+      // the poses between the nodes about half a cell apart
+      const int samples = (int)std::ceil(length * 2);
+
+      for (int bY = 0; bY < buckets; ++bY) {
+        for (int bX = 0; bX < buckets; ++bX) {
+          std::fill(cells.begin(), cells.end(), 0);
+
+          for (int pY = bY * part; pY < (bY + 1) * part; ++pY) {
+            for (int pX = bX * part; pX < (bX + 1) * part; ++pX) {
+              for (int k = 1; k < samples; ++k) {
+                const double s = (double)k / samples;
+                double lx = dt == 0 ? s * Node3D::dx[p] : radius * std::sin(s * std::abs(dt));
+                double ly = dt == 0 ? 0 : (Node3D::dy[p] < 0 ? -1 : 1) * radius * (1 - std::cos(s * dt));
+
+                if (!forward) { lx = -lx; }
+
+                const double x = (double)pX / resolution + lx * std::cos(t) - ly * std::sin(t);
+                const double y = (double)pY / resolution + lx * std::sin(t) + ly * std::cos(t);
+                const float h = Helper::normalizeHeadingRad(t + (forward ? s : -s) * dt);
+
+                // the footprint of the collision lookup at the pose
+                const int X = (int)std::floor(x);
+                const int Y = (int)std::floor(y);
+                int iX = (int)((x - X) * resolution);
+                int iY = (int)((y - Y) * resolution);
+                iX = iX < resolution ? iX : resolution - 1;
+                iY = iY < resolution ? iY : resolution - 1;
+                const int iT = (int)(h / parameters.deltaHeadingRad()) % parameters.headings;
+
+                for (const Run& run : runs[(iY * resolution + iX) * parameters.headings + iT]) {
+                  char* row = &cells[(origin + X + run.x) * size + origin + Y + run.y];
+                  std::fill(row, row + run.length, 1);
+                }
+              }
+            }
+          }
+
+          // pack the cells into a bit mask per row of their bounding box
+          Mask& mask = masks[((bin * count + i) * buckets + bY) * buckets + bX];
+          int minX = size, maxX = -1, minY = size, maxY = -1;
+
+          for (int x = 0; x < size; ++x) {
+            for (int y = 0; y < size; ++y) {
+              if (cells[x * size + y]) {
+                minX = std::min(minX, x);
+                maxX = std::max(maxX, x);
+                minY = std::min(minY, y);
+                maxY = std::max(maxY, y);
+              }
+            }
+          }
+
+          mask.x = minX - origin;
+          mask.y = minY - origin;
+          mask.rows = maxX - minX + 1;
+          mask.words = (maxY - minY) / BinaryGrid::wordBits + 1;
+          mask.offset = words.size();
+          words.resize(words.size() + mask.rows * mask.words, 0);
+
+          for (int x = minX; x <= maxX; ++x) {
+            for (int y = minY; y <= maxY; ++y) {
+              if (cells[x * size + y]) {
+                const int c = y - minY;
+                words[mask.offset + (x - minX) * mask.words + c / BinaryGrid::wordBits] |= (uint64_t)1 << (c % BinaryGrid::wordBits);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,88 @@
+#include "threadpool.h"
+
+#include <algorithm>
+
+using namespace HybridAStar;
+
+ThreadPool::ThreadPool(int threads) {
+  if (threads <= 0) { threads = std::max(1u, std::thread::hardware_concurrency()); }
+
+  for (int i = 1; i < threads; ++i) { workers.push_back(std::thread(&ThreadPool::run, this)); }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+  }
+  start.notify_all();
+
+  for (std::thread& worker : workers) { worker.join(); }
+}
+
+void ThreadPool::parallelFor(int n, const Range& range) {
+  if (n <= 0) { return; }
+
+  if (workers.empty()) {
+    range(0, n);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->range = &range;
+    this->n = n;
+    // a few chunks per thread, so a slow thread does not hold up the loop
+    chunk = std::max(1, n / (4 * size()));
+    next = 0;
+    ++generation;
+  }
+  start.notify_all();
+
+  while (work()) {}
+
+  std::unique_lock<std::mutex> lock(mutex);
+  done.wait(lock, [this]() { return next >= this->n && busy == 0; });
+  this->range = nullptr;
+}
+
+bool ThreadPool::work() {
+  int begin, end;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (!range || next >= n) { return false; }
+
+    begin = next;
+    end = std::min(n, begin + chunk);
+    next = end;
+    ++busy;
+  }
+
+  (*range)(begin, end);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    --busy;
+  }
+  done.notify_one();
+  return true;
+}
+
+void ThreadPool::run() {
+  unsigned seen = 0;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      start.wait(lock, [&]() { return stop || generation != seen; });
+
+      if (stop) { return; }
+
+      seen = generation;
+    }
+
+    while (work()) {}
+  }
+}